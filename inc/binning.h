@@ -0,0 +1,57 @@
+#ifndef BINNING_H
+#define BINNING_H
+
+#include <vector>
+#include <cstddef>
+#include <span>
+
+// Bin counts of one feature over [min, max], with equal-width bins.
+struct Histogram1D {
+    double min = 0.0;
+    double max = 0.0;
+    std::vector<size_t> counts;
+};
+
+// Bin counts of a feature pair over a regular grid, stored row-major (y * xBins + x).
+struct Histogram2D {
+    double xMin = 0.0;
+    double xMax = 0.0;
+    double yMin = 0.0;
+    double yMax = 0.0;
+    size_t xBins = 0;
+    size_t yBins = 0;
+    std::vector<size_t> counts;
+};
+
+class Binning {
+public:
+    // Maximum number of bins produced by the automatic bin count.
+    static constexpr size_t MaxAutomaticBins = 128;
+
+    // Maximum number of bins accepted from the command line, so that the bins * bins cells of every density grid
+    // stay small.
+    static constexpr size_t MaxBins = 256;
+
+    // Return the Freedman-Diaconis bin count of a dataset, ignoring NaN values.
+    static size_t FreedmanDiaconisBinCount(std::span<const double> data);
+
+    // Count the values of a dataset into a fixed number of bins over [min, max], ignoring NaN values.
+    static Histogram1D Histogram(std::span<const double> data, size_t bins, double min, double max);
+
+    // Count the value pairs of two datasets into a bins x bins grid, ignoring pairs with a NaN value.
+    static Histogram2D Density(std::span<const double> dataX, std::span<const double> dataY, size_t bins,
+        double xMin, double xMax, double yMin, double yMax);
+
+    // Values of every feature of every group, indexed [group][feature], read in place.
+    using GroupViews = std::vector<std::vector<std::span<const double>>>;
+
+    // Compute the histograms of every feature for every group, indexed [feature][group].
+    // Groups of the same feature share their bin edges. A bin count of 0 selects Freedman-Diaconis.
+    static std::vector<std::vector<Histogram1D>> HistogramsByGroup(const GroupViews& valuesByGroup, size_t bins);
+
+    // Compute the density grids of every feature pair (i < j) for every group, indexed [pair][group].
+    // Pairs are enumerated in (0, 1), (0, 2), ..., (1, 2), ... order and share their ranges across groups.
+    static std::vector<std::vector<Histogram2D>> DensityGridsByGroup(const GroupViews& valuesByGroup, size_t bins);
+};
+
+#endif // BINNING_H
@@ -1,30 +1,61 @@
 #ifndef CALCULATE_H
 #define CALCULATE_H
 
+#include <cstddef>
+#include <span>
 #include <vector>
 
+struct FeatureColumn;
+
+// Read-only view of `size` doubles spaced `stride` apart: a contiguous range of a column (stride 1), or a column of
+// row-major storage (stride = columns). Spans and vectors convert to it, so statistics read them without copies.
+struct StridedView {
+	const double* data = nullptr;
+	size_t size = 0;
+	size_t stride = 1;
+
+	StridedView() = default;
+	StridedView(const double* data, size_t size, size_t stride = 1) : data(data), size(size), stride(stride) {}
+	StridedView(std::span<const double> values) : data(values.data()), size(values.size()) {}
+	StridedView(const std::vector<double>& values) : data(values.data()), size(values.size()) {}
+
+	const double& operator[](size_t i) const { return data[i * stride]; }
+
+	// Return the view of the elements [begin, end).
+	StridedView subview(size_t begin, size_t end) const { return StridedView(data + begin * stride, end - begin, stride); }
+};
+
 class Calculate {
 public:
 	// Calculate and return the mean of a dataset
-	static double Mean(const std::vector<double>& data);
+	static double Mean(StridedView data);
 
 	// Calculate and return the standard deviation of a dataset
-	static double StandardDeviation(const std::vector<double>& data);
+	static double StandardDeviation(StridedView data);
 
 	// Calculate and return the minimum value of a dataset
-	static double Min(const std::vector<double>& data);
+	static double Min(StridedView data);
 
 	// Calculate and return the maximum value of a dataset
-	static double Max(const std::vector<double>& data);
+	static double Max(StridedView data);
 
 	// Calculate and return the percentile of a dataset
-	static double Quartile(const std::vector<double>& data, int n);
+	static double Quartile(StridedView data, int n);
+
+	// Same statistics over the valid rows of a feature column. Fully valid 64-row blocks are reduced without
+	// any per-row test, only blocks holding missing rows read their validity bits.
+	static double Count(const FeatureColumn& column);
+	static double Mean(const FeatureColumn& column);
+	static double StandardDeviation(const FeatureColumn& column);
+	static double Min(const FeatureColumn& column);
+	static double Max(const FeatureColumn& column);
+	static double Quartile(const FeatureColumn& column, int n);
 
 	// Calculate and return the covariance between two datasets
-	static double Covariance(const std::vector<double>& data1, const std::vector<double>& data2);
+	static double Covariance(StridedView data1, StridedView data2);
 
 	// Calculate and return the Pearson correlation coefficient between two datasets
-	static double PearsonCorrelation(const std::vector<double>& data1, const std::vector<double>& data2);
+	static double PearsonCorrelation(StridedView data1, StridedView data2);
 
 	static double LogisticRegressionHypothesis(const std::vector<double>& weights, const std::vector<double>& inputs);
 
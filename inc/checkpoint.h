@@ -0,0 +1,75 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+// State of a training between two epochs, from which it continues exactly as if it had not stopped.
+// Plain gradient descent with a fixed learning rate keeps no optimizer state beyond the weights.
+struct TrainingCheckpoint {
+    // Epochs completed by the weights, out of `epochs`.
+    size_t epoch = 0;
+    size_t epochs = 0;
+    // Training rows and normalization of the run, to refuse resuming it over other data.
+    size_t rows = 0;
+    std::vector<size_t> selectedFeatures;
+    std::vector<double> featureMeans;
+    std::vector<double> featureStdDevs;
+    std::vector<std::vector<double>> weights;
+    // State of the generator that drew the initial weights, as written by its stream operator.
+    std::string generator;
+};
+
+// Checkpointing of a training, requested on the command line.
+struct CheckpointOptions {
+    // Epochs between two checkpoints, 0 to write none.
+    size_t interval = 0;
+    // Continue from the checkpoint of the model when there is one.
+    bool resume = false;
+};
+
+class Checkpoint {
+public:
+    // Magic line of the checkpoint files.
+    static constexpr const char* Magic = "DSLRCHECKPOINT1";
+
+    // Return the path of the checkpoint file of a model file.
+    static std::string Path(const std::string& modelPath);
+
+    // Read a checkpoint file, returning false when it is missing and throwing when it is invalid.
+    static bool Load(const std::string& path, TrainingCheckpoint& checkpoint);
+
+    // Write a checkpoint file atomically, with the doubles in hexadecimal so that they read back exactly.
+    static void Save(const std::string& path, const TrainingCheckpoint& checkpoint);
+
+    // Background thread writing the checkpoints submitted by a training, so that the epochs never wait on the disk.
+    // A checkpoint submitted while the previous one is still pending replaces it. The destructor writes the
+    // pending checkpoint before joining the thread.
+    class Writer {
+    public:
+        explicit Writer(std::string path);
+        ~Writer();
+
+        Writer(const Writer&) = delete;
+        Writer& operator=(const Writer&) = delete;
+
+        void Submit(TrainingCheckpoint checkpoint);
+
+    private:
+        void run();
+
+        std::string path;
+        std::mutex mutex;
+        std::condition_variable ready;
+        std::optional<TrainingCheckpoint> pending;
+        bool stopping = false;
+        std::thread thread;
+    };
+};
+
+#endif // CHECKPOINT_H
@@ -0,0 +1,73 @@
+#ifndef COLUMN_STATS_H
+#define COLUMN_STATS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Mergeable summary of the non-missing values of a column: moments, extrema and a quantile sketch.
+struct ColumnSummary {
+    size_t count = 0;
+    double sum = 0.0;
+    double mean = 0.0;
+    // Sum of the squared deviations from the mean.
+    double m2 = 0.0;
+    double min = std::numeric_limits<double>::infinity();
+    double max = -std::numeric_limits<double>::infinity();
+    // Quantile sketch: centroids (mean, weight) sorted by mean, compressed to about ColumnStats::SketchSize.
+    std::vector<std::pair<double, double>> centroids;
+};
+
+// Summaries of every feature of a CSV file, up to a byte offset, as stored in its `.stats` sidecar file.
+struct DatasetSummary {
+    std::vector<std::string> headers;
+    size_t featuresStartIndex = 0;
+    size_t rows = 0;
+    // End of the summarized bytes, and checksum of the bytes around it to detect a rewritten file.
+    size_t offset = 0;
+    uint64_t checksum = 0;
+    std::vector<ColumnSummary> columns;
+};
+
+class ColumnStats {
+public:
+    // Magic line of the sidecar files.
+    static constexpr const char* Magic = "DSLRSTATS1";
+
+    // Number of centroids kept by the quantile sketches, which bounds their rank error to about 1 / SketchSize.
+    static constexpr size_t SketchSize = 512;
+
+    // Add a value to a summary. NaN values are missing and ignored.
+    static void Add(ColumnSummary& summary, double value);
+
+    // Merge the summary of other rows into a summary, with the parallel variance formula of Chan et al.
+    static void Merge(ColumnSummary& summary, const ColumnSummary& other);
+
+    // Return the population standard deviation of the values.
+    static double StandardDeviation(const ColumnSummary& summary);
+
+    // Return the estimated percentile (0 to 100) of the values, interpolated linearly between ranks.
+    static double Percentile(const ColumnSummary& summary, double percent);
+
+    // Return the path of the sidecar file of a CSV file.
+    static std::string SidecarPath(const std::string& filename);
+
+    // Return the summary of a CSV file, reading only the lines appended since its sidecar file was written,
+    // or the whole file when the sidecar is missing or does not match the file anymore. The sidecar is then updated.
+    static DatasetSummary UpdateFile(const std::string& filename);
+
+    // Return the merged summary of the shards listed by `filenames` (see Utils::ExpandDataFiles), each one updated
+    // concurrently with its own sidecar. The offset and checksum of a merged summary are 0.
+    static DatasetSummary Update(const std::string& filenames);
+
+    // Read a sidecar file, returning false when it is missing or invalid.
+    static bool Load(const std::string& path, DatasetSummary& dataset);
+
+    // Write a sidecar file atomically.
+    static void Save(const std::string& path, const DatasetSummary& dataset);
+};
+
+#endif // COLUMN_STATS_H
@@ -0,0 +1,77 @@
+#ifndef COMMANDS_H
+#define COMMANDS_H
+
+#include <iostream>
+#include <string>
+#include "utils.h"
+#include "column_stats.h"
+#include "checkpoint.h"
+#include "feature_column.h"
+#include "sweep.h"
+#include "feature_selection.h"
+
+// Analyses of the dslr tools, run over an already loaded dataset. They only read the dataset, so several of them
+// can run concurrently over the same one, and write their report to `out`.
+class Commands {
+public:
+    // Print the count, mean, standard deviation, extrema and quartiles of every feature.
+    static void Describe(const Dataset& dataset, std::ostream& out = std::cout);
+
+    // Print the same statistics over the compressed columns of a dataset, decoded block by block.
+    static void Describe(const CompactDataset& dataset, std::ostream& out = std::cout);
+
+    // Print the same statistics from the column summaries of a file, with estimated quartiles.
+    static void DescribeSummary(const DatasetSummary& summary, std::ostream& out = std::cout);
+
+    // Print the standard deviation of every feature by house and plot their distributions,
+    // with `bins` bins per histogram (0 for Freedman-Diaconis).
+    static void Histogram(const Dataset& dataset, size_t bins, std::ostream& out = std::cout);
+
+    // Print the correlations between features and plot the two most similar ones.
+    static void ScatterPlot(const Dataset& dataset, std::ostream& out = std::cout);
+
+    // Plot the scatter plot matrix of the features, with `bins` bins per axis of the density grids.
+    static void PairPlot(const Dataset& dataset, size_t bins, std::ostream& out = std::cout);
+
+    // Train the one-vs-all models on a copy of the students and save them to `modelPath`. The training state is written
+    // to the checkpoint file of the model every `checkpoint.interval` epochs, and continued from it with `checkpoint.resume`.
+    static void Train(const Dataset& dataset, const std::string& modelPath = "models.save", std::ostream& out = std::cout,
+        const CheckpointOptions& checkpoint = {});
+
+    // Train the models on the selected features decoded from the compressed columns of a dataset.
+    static void Train(const CompactDataset& dataset, const std::string& modelPath = "models.save", std::ostream& out = std::cout,
+        const CheckpointOptions& checkpoint = {});
+
+    // Train the models on `folds` folds of the students, each time holding one out, and print the accuracy and
+    // log-loss of every fold on its held-out rows and their means. No model is saved.
+    static void CrossValidate(const Dataset& dataset, size_t folds, std::ostream& out = std::cout);
+
+    // Select the features of the models by a stepwise search over every feature of the students, holding out a fifth
+    // of them, then train the models on the selected features and save them to `modelPath` with their indices.
+    static void SelectFeatures(const Dataset& dataset, const SelectionSettings& settings,
+        const std::string& modelPath = "models.save", std::ostream& out = std::cout);
+
+    // Train the models with every setting of a sweep, or `randomTrials` settings drawn within its ranges when it is
+    // not 0, holding out a fifth of the students. Print the best trials and write them all to the JSON leaderboard
+    // `leaderboardPath`, by increasing log-loss on the held-out students. No model is saved.
+    static void Sweep(const Dataset& dataset, const SweepSpace& space, size_t randomTrials,
+        const std::string& leaderboardPath = "leaderboard.json", std::ostream& out = std::cout);
+
+    // Update the models of `modelPath` with `epochs` gradient steps over new students only, starting from the saved
+    // weights. When `refreshNormalization` is set, the normalization is merged with the moments of the new students.
+    static void PartialFit(const Dataset& dataset, const std::string& modelPath = "models.save", size_t epochs = 10,
+        bool refreshNormalization = false, std::ostream& out = std::cout);
+
+    // Predict the house of a copy of the students with the models of `modelPath` and write them to `outputPath`.
+    static void Predict(const Dataset& dataset, const std::string& modelPath = "models.save",
+        const std::string& outputPath = "houses.csv", std::ostream& out = std::cout);
+
+    // Predict the house of the students with several model files in one pass: the features used by any of them are
+    // gathered once into shared columns, keeping the missing values, which every model imputes with its own means and
+    // normalizes with its own parameters. Write one prediction column per model to `outputPath` and print how often
+    // the models disagree.
+    static void PredictModels(const Dataset& dataset, const std::vector<std::string>& modelPaths,
+        const std::string& outputPath = "houses.csv", std::ostream& out = std::cout);
+};
+
+#endif // COMMANDS_H
@@ -0,0 +1,106 @@
+#ifndef CROSS_VALIDATION_H
+#define CROSS_VALIDATION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "utils.h"
+
+// Selected features of every student in one row-major block, with NaN for the missing values, and their house.
+// The rows are shuffled once when the matrix is built, so that every fold is a contiguous range of rows.
+struct DesignMatrix {
+    size_t rows = 0;
+    size_t columns = 0;
+    std::vector<double> values;
+    // House index of every row (see LogisticRegression::HousesIndex), or the houses count when it has none.
+    std::vector<uint8_t> houses;
+
+    const double* row(size_t row) const { return values.data() + row * columns; }
+};
+
+// View of one fold over a design matrix: its validation rows are [validationBegin, validationEnd), and its
+// training rows all the other ones, so that the folds share the matrix without copying any row.
+struct FoldView {
+    const DesignMatrix* matrix = nullptr;
+    size_t validationBegin = 0;
+    size_t validationEnd = 0;
+
+    size_t trainingRows() const { return matrix->rows - (validationEnd - validationBegin); }
+
+    // Return the row of the matrix holding training row `position` (0 to trainingRows() - 1).
+    size_t trainingRow(size_t position) const {
+        return position < validationBegin ? position : position + (validationEnd - validationBegin);
+    }
+
+    // Call function(row) for every training row, in order.
+    template <typename Function>
+    void forEachTrainingRow(Function function) const {
+        for (size_t row = 0; row < validationBegin; ++row) {
+            function(row);
+        }
+        for (size_t row = validationEnd; row < matrix->rows; ++row) {
+            function(row);
+        }
+    }
+};
+
+// Normalization fitted on the training rows of a fold: a value v becomes (v - offset) * scale, a missing one `missing`.
+struct FoldScaling {
+    std::vector<double> offsets;
+    std::vector<double> scales;
+    std::vector<double> missing;
+};
+
+// Optimization of the models: full batch gradient descent as by LogisticRegression::TrainModels, or descent over
+// mini-batches of rows, or stochastic descent over single rows, both visiting their batches in a new order every epoch.
+enum class Solver { Batch, MiniBatch, Stochastic };
+
+// Hyperparameters of a training.
+struct TrainingSettings {
+    double learningRate = 0.1;
+    size_t epochs = 100;
+    // Strength of the L2 penalty (l2 / 2) * |w|^2 added to the log-loss.
+    double l2 = 0.0;
+    Solver solver = Solver::Batch;
+    // Rows of a mini-batch.
+    size_t batchSize = 64;
+
+    // Return the name of a solver, as given on the command line.
+    static const char* SolverName(Solver solver);
+
+    // Return the solver of a name, throwing when it is unknown.
+    static Solver ParseSolver(const std::string& name);
+};
+
+// Scores of the model of one fold over its validation rows.
+struct FoldResult {
+    size_t trainingRows = 0;
+    size_t validationRows = 0;
+    // Percentage of validation rows whose house is the predicted one.
+    double accuracy = 0.0;
+    // Log-loss of the one-vs-all models, averaged over the houses.
+    double logLoss = 0.0;
+};
+
+class CrossValidation {
+public:
+    // Build the design matrix of the selected features (1-based indices) of the students, in an order shuffled by `seed`.
+    static DesignMatrix Build(const Dataset& dataset, const std::vector<size_t>& selectedFeatures, uint64_t seed);
+
+    // Return the view of fold `fold` out of `folds`, whose sizes differ by one row at most.
+    static FoldView Fold(const DesignMatrix& matrix, size_t fold, size_t folds);
+
+    // Fit the imputation and normalization of a fold in one pass over its training rows.
+    static FoldScaling FitScaling(const FoldView& fold);
+
+    // Train the models on the training rows of a fold, normalized on the fly, and score them on its validation rows.
+    // The fold and its scaling are only read, so several trainings can share them.
+    static FoldResult TrainFold(const FoldView& fold, const FoldScaling& scaling, const TrainingSettings& settings, uint64_t seed);
+
+    // Train the models of every fold concurrently, each one with the scaling of its own training rows only,
+    // and score them on their validation rows.
+    static std::vector<FoldResult> Run(const DesignMatrix& matrix, size_t folds, const TrainingSettings& settings, uint64_t seed);
+};
+
+#endif // CROSS_VALIDATION_H
@@ -0,0 +1,42 @@
+#ifndef DSLR_H
+#define DSLR_H
+
+#include <stddef.h>
+
+/* C interface of libdslr, scoring rows in process with a model saved by logreg_train. */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct dslr_model dslr_model;
+
+/* Load a model file. Return NULL on failure, see dslr_last_error. */
+dslr_model* dslr_model_load(const char* path);
+
+/* Return the number of values of a row: the features of the model, in the order of their columns in the data files. */
+size_t dslr_model_features(const dslr_model* model);
+
+/* Return the number of classes of a model. */
+size_t dslr_model_classes(const dslr_model* model);
+
+/* Return the name of a class (house) of a model, or NULL when out of range. */
+const char* dslr_class_name(const dslr_model* model, int class_index);
+
+/* Score `n` rows of dslr_model_features(model) raw values each, stored one after the other, NaN when missing.
+   Write the most probable class of each row to `out_class` and its probability to `out_proba`, either of which
+   may be NULL. The rows are read in place, without copy nor allocation, and a model can score from several
+   threads at once. Return 0 on success, -1 on failure. */
+int dslr_score_batch(const dslr_model* model, const double* rows, size_t n, int* out_class, double* out_proba);
+
+/* Free a model. NULL is ignored. */
+void dslr_model_free(dslr_model* model);
+
+/* Return the message of the last failure of the calling thread. */
+const char* dslr_last_error(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DSLR_H */
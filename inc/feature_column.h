@@ -0,0 +1,111 @@
+#ifndef FEATURE_COLUMN_H
+#define FEATURE_COLUMN_H
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "utils.h"
+
+// Values of a feature with a packed validity bitmap, as in Arrow, instead of NaN sentinels.
+// A column is built as doubles, then can be compressed to a narrower encoding and read back block by block.
+struct FeatureColumn {
+    // Number of rows described by one validity word, and decoded at once.
+    static constexpr size_t BlockSize = 64;
+
+    // Storage of the values: doubles, floats, or frame of reference (base + offset * step) with 1, 2 or 4 byte offsets.
+    enum class Encoding { Float64, Float32, FrameOfReference };
+
+    Encoding encoding = Encoding::Float64;
+    // Values of a Float64 column. Missing rows hold 0 so that sums over a block need no mask.
+    std::vector<double> values;
+    // Values of a Float32 column.
+    std::vector<float> floats;
+    // Offsets of a FrameOfReference column, `offsetWidth` bytes each in native byte order.
+    std::vector<uint8_t> offsets;
+    size_t offsetWidth = 0;
+    double base = 0.0;
+    double step = 0.0;
+    // Bit `row % 64` of word `row / 64` is set when the row has a value. Bits past the last row are clear.
+    std::vector<uint64_t> validity;
+    size_t rows = 0;
+
+    // Append a row, missing when the value is NaN. Only Float64 columns can grow.
+    void push_back(double value);
+
+    size_t size() const { return rows; }
+
+    bool isValid(size_t row) const { return (validity[row / BlockSize] >> (row % BlockSize)) & 1; }
+
+    // Return the number of rows with a value.
+    size_t count() const;
+
+    // Return the values of a block, decoded into `buffer` unless the column holds doubles. Missing rows read as 0.
+    const double* block(size_t block, double* buffer) const;
+
+    // Switch to the narrowest encoding whose error on every value is at most `tolerance`: frame of reference when
+    // `tolerance` is positive and the range fits 32-bit offsets, else floats when they are close enough, else doubles.
+    void Compress(double tolerance);
+
+    // Switch a Float64 column to floats whatever their rounding, halving its bytes. The statistics still decode and
+    // accumulate in doubles, so only the rounding of each value (7 significant digits) is lost.
+    void ToFloat32();
+
+    // Return the bytes held by the column.
+    size_t MemoryBytes() const;
+
+    // Build the columns of every feature of the students.
+    static std::vector<FeatureColumn> FromStudents(const std::vector<StudentInfo>& students);
+};
+
+// Label column stored as codes into a dictionary of its distinct values.
+struct LabelColumn {
+    std::vector<std::string> dictionary;
+    std::vector<uint32_t> codes;
+
+    // Append a row, adding its value to the dictionary when it is new.
+    void push_back(const std::string& value);
+
+    size_t size() const { return codes.size(); }
+
+    const std::string& operator[](size_t row) const { return dictionary[codes[row]]; }
+
+    // Drop the lookup table used while appending.
+    void Seal();
+
+    // Return the bytes held by the column.
+    size_t MemoryBytes() const;
+
+private:
+    std::unordered_map<std::string, uint32_t> lookup;
+};
+
+// Dataset held by columns with compact encodings, to fit more rows in memory than the rows of StudentInfo.
+struct CompactDataset {
+    std::vector<std::string> headers;
+    size_t featuresStartIndex = 0;
+    std::vector<size_t> indices;
+    std::vector<LabelColumn> labels;
+    std::vector<FeatureColumn> features;
+    // Feature column of the file (0-based) held at each position of `features`.
+    std::vector<size_t> featureColumns;
+
+    size_t size() const { return indices.size(); }
+
+    // Return the bytes held by the columns.
+    size_t MemoryBytes() const;
+
+    // Load data files like Utils::LoadDataset, converting every shard to columns by chunks of rows while it is parsed,
+    // then compress the features within `tolerance` (see FeatureColumn::Compress).
+    static CompactDataset Load(const std::string& filenames, double tolerance, const ColumnProjection* projection = nullptr);
+
+    // Store every feature column still held as doubles as floats (see FeatureColumn::ToFloat32).
+    void ToFloat32();
+
+    // Decode the students with only some of their features, block by block, like Utils::SelectFeatures.
+    std::vector<StudentInfo> SelectFeatures(const std::vector<size_t>& featureColumns, bool keepLabels) const;
+};
+
+#endif // FEATURE_COLUMN_H
@@ -0,0 +1,65 @@
+#ifndef FEATURE_SELECTION_H
+#define FEATURE_SELECTION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "cross_validation.h"
+
+// Imputed and normalized values of every feature of a design matrix, one column each, in the order of its rows.
+// The candidate subsets of a search all read this one store.
+struct NormalizedColumns {
+    size_t rows = 0;
+    std::vector<std::vector<double>> columns;
+    std::vector<uint8_t> houses;
+};
+
+// Direction of a stepwise search: adding the best feature at each step from none, or removing the least useful one
+// at each step from all of them.
+enum class SelectionMethod { Forward, Backward };
+
+struct SelectionSettings {
+    SelectionMethod method = SelectionMethod::Forward;
+    // Epochs of gradient descent given to every candidate, from the weights of its parent.
+    size_t epochs = 30;
+    double learningRate = 0.1;
+    // Features correlated above this (in absolute value) with a feature kept before them are never candidates.
+    double maxCorrelation = 0.95;
+    // Relative change of the validation log-loss below which a step is not worth it.
+    double tolerance = 0.001;
+    // Students the search runs on, drawn at random, 0 for all of them. The final models train on all of them.
+    size_t sampleRows = 50000;
+};
+
+// Subset of features (positions in the columns) with the models trained on it and their scores on the validation rows.
+struct FeatureSubset {
+    std::vector<size_t> features;
+    std::vector<std::vector<double>> weights;
+    FoldResult result;
+};
+
+class FeatureSelection {
+public:
+    // Return the selection method of a name (forward or backward), throwing when it is unknown.
+    static SelectionMethod ParseMethod(const std::string& name);
+
+    // Impute and normalize every column of the matrix with the statistics of the training rows of a fold.
+    static NormalizedColumns Normalize(const FoldView& fold, const FoldScaling& scaling);
+
+    // Return the features of the columns, in order, without the ones correlated above `maxCorrelation` with a kept one.
+    static std::vector<size_t> PruneCorrelated(const NormalizedColumns& store, const FoldView& fold, double maxCorrelation);
+
+    // Train the models of a subset on the training rows of a fold from `weights` (one row per house, one weight per
+    // feature of the subset), and score them on its validation rows.
+    static FeatureSubset Train(const NormalizedColumns& store, const FoldView& fold, std::vector<size_t> features,
+        std::vector<std::vector<double>> weights, const SelectionSettings& settings);
+
+    // Run a stepwise search over the candidate features, evaluating the subsets of every step concurrently, and return
+    // the selected subset, which holds at least one feature. Each step is printed to `out` with the names of the features.
+    static FeatureSubset Search(const NormalizedColumns& store, const FoldView& fold, const std::vector<size_t>& candidates,
+        const std::vector<std::string>& names, const SelectionSettings& settings, std::ostream& out);
+};
+
+#endif // FEATURE_SELECTION_H
@@ -0,0 +1,87 @@
+#ifndef LOGREG_H
+#define LOGREG_H
+
+#include <functional>
+#include <iostream>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "utils.h"
+
+class LogisticRegression {
+public:
+    // Called after every epoch with the number of completed epochs and the weights they reached.
+    using EpochCallback = std::function<void(size_t, const std::vector<std::vector<double>>&)>;
+
+    // Houses predicted by the one-vs-all models, indexed by model.
+    static const std::unordered_map<size_t, std::string> HousesIndex;
+
+    // Features (1-based indices) the models are trained on.
+    static const std::vector<size_t> DefaultSelectedFeatures;
+
+    // Return the projection loading the house label and the given features (1-based indices) only.
+    static ColumnProjection TrainingProjection(const std::vector<size_t>& selectedFeatures, bool withHouse);
+
+    // Replace missing feature values (NaN) with the mean of their feature.
+    static void HandleMissingValues(std::vector<StudentInfo>& students);
+
+    // Replace missing feature values (NaN) with the value given for their feature, such as the training means of a
+    // model, so that every row is imputed alike whatever the file it comes from.
+    static void HandleMissingValues(std::vector<StudentInfo>& students, const std::vector<double>& featureValues);
+
+    // Initialize the weights randomly and build the selected inputs and one-hot house labels.
+    static void SetupTrainingData(const std::vector<StudentInfo>& students,
+        const std::vector<size_t>& selectedFeatures,
+        const std::unordered_map<size_t, std::string>& houseIndex,
+        std::vector<std::vector<double>>& weights,
+        std::vector<std::vector<double>>& trainingInputs,
+        std::vector<std::vector<double>>& trainingLabels);
+
+    // Draw every weight uniformly in [-0.5, 0.5) from `generator`, house by house.
+    static void InitializeWeights(std::vector<std::vector<double>>& weights, std::mt19937& generator);
+
+    // Build the selected inputs and one-hot house labels, keeping the weights.
+    static void CreateTrainingData(const std::vector<StudentInfo>& students,
+        const std::vector<size_t>& selectedFeatures,
+        const std::unordered_map<size_t, std::string>& houseIndex,
+        std::vector<std::vector<double>>& trainingInputs,
+        std::vector<std::vector<double>>& trainingLabels);
+
+    // Return the log-loss of the model of a house.
+    static double LossFunction(const std::vector<std::vector<double>>& inputs, const std::vector<std::vector<double>>& weights,
+        const std::vector<std::vector<double>>& target, const size_t house);
+
+    // Perform one gradient descent step on the model of a house.
+    static void GradientDescent(const std::vector<std::vector<double>>& inputs, std::vector<std::vector<double>>& weights,
+        const std::vector<std::vector<double>>& target, const size_t house);
+
+    // Train every house model up to a number of epochs, printing the loss and accuracy of each epoch to `out`.
+    // Weights that already completed `firstEpoch` epochs continue from there, and `onEpoch` is called after each one.
+    static void TrainModels(std::vector<std::vector<double>>& weights, const std::vector<std::vector<double>>& inputs,
+        const std::vector<std::vector<double>>& targets, const size_t epochs, std::ostream& out = std::cout,
+        const size_t firstEpoch = 0, const EpochCallback& onEpoch = nullptr);
+
+    // Build the input vectors of the selected features (1-based indices).
+    static void CreateInputVectors(const std::vector<StudentInfo>& students,
+        const std::vector<size_t>& featuresSelected,
+        std::vector<std::vector<double>>& inputs);
+
+    // Write a self-contained C++ header scoring rows with a model: its weights, normalization and imputation values
+    // and selected features as constexpr arrays, and a constexpr `score(const double* row)` in namespace `name`.
+    static void WriteScorer(const std::vector<std::vector<double>>& weights,
+        const std::vector<double>& featureMeans,
+        const std::vector<double>& featureStdDevs,
+        const std::vector<size_t>& selectedFeatures,
+        const std::string& name,
+        std::ostream& out);
+
+    // Predict the house of every student and write the results to a CSV file.
+    static void PerformPredictions(const std::vector<StudentInfo>& students,
+        const std::vector<std::vector<double>>& weights,
+        const std::vector<std::string>& headers,
+        const std::vector<std::vector<double>>& inputs,
+        const std::string& outputPath = "houses.csv");
+};
+
+#endif // LOGREG_H
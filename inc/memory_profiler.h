@@ -0,0 +1,46 @@
+#ifndef MEMORY_PROFILER_H
+#define MEMORY_PROFILER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Allocation counts of the whole process, gathered by the replaced global operators new and delete.
+class MemoryProfiler {
+public:
+    // Counters of the allocations made since the memory profiler was enabled.
+    struct Sample {
+        uint64_t allocations = 0;
+        uint64_t deallocations = 0;
+        uint64_t bytes = 0;
+
+        // Return the allocations made between `start` and this sample.
+        Sample operator-(const Sample& start) const;
+    };
+
+    // Check if the allocations are counted.
+    static bool Enabled() { return enabled.load(std::memory_order_relaxed); }
+
+    // Start counting the allocations.
+    static void Enable();
+
+    // Read the allocation counters. Allocations of every thread are counted, so a phase running while other
+    // threads allocate is also charged with their allocations.
+    static Sample Read();
+
+    // Record one allocation of `size` bytes, or one deallocation, when the memory profiler is enabled.
+    static void RecordAllocation(size_t size);
+    static void RecordDeallocation();
+
+    // Return the peak resident set size of the process since it started in bytes (VmHWM in /proc/self/status), or 0
+    // when unknown. It is not reset between phases, so it cannot tell the peak of a single phase.
+    static uint64_t ProcessPeakResidentBytes();
+
+private:
+    static inline std::atomic<bool> enabled{ false };
+    static inline std::atomic<uint64_t> allocations{ 0 };
+    static inline std::atomic<uint64_t> deallocations{ 0 };
+    static inline std::atomic<uint64_t> bytes{ 0 };
+};
+
+#endif // MEMORY_PROFILER_H
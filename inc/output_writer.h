@@ -0,0 +1,62 @@
+#ifndef OUTPUT_WRITER_H
+#define OUTPUT_WRITER_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+// Output file written by a dedicated thread from two large buffers: rows are formatted into one buffer while the
+// other one is written, so that the callers never wait on the disk unless it is slower than their formatting.
+class OutputWriter {
+public:
+    // Size of each of the two buffers.
+    static constexpr size_t DefaultBufferSize = 1 << 20;
+
+    // Open the file for writing, throwing when it cannot be created.
+    explicit OutputWriter(const std::string& path, size_t bufferSize = DefaultBufferSize);
+
+    // Close the file when Close() was not called, ignoring the errors.
+    ~OutputWriter();
+
+    OutputWriter(const OutputWriter&) = delete;
+    OutputWriter& operator=(const OutputWriter&) = delete;
+
+    void Append(std::string_view text);
+
+    void Append(char character);
+
+    // Append an integer formatted with std::to_chars.
+    void Append(size_t value);
+
+    // Write the remaining bytes, stop the thread and close the file, throwing when any write failed.
+    void Close();
+
+private:
+    // Hand the filled buffer to the thread and continue in the other one, once the thread is done with it.
+    void swapBuffers();
+
+    void run();
+
+    std::string path;
+    std::FILE* file = nullptr;
+    std::vector<char> buffers[2];
+    // Buffer being filled, and bytes it holds.
+    size_t current = 0;
+    size_t used = 0;
+
+    std::mutex mutex;
+    std::condition_variable changed;
+    // Bytes of the buffer handed to the thread, 0 when it has none.
+    size_t pendingBytes = 0;
+    size_t pendingBuffer = 0;
+    bool stopping = false;
+    bool failed = false;
+    std::thread thread;
+};
+
+#endif // OUTPUT_WRITER_H
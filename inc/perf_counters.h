@@ -0,0 +1,49 @@
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+#include <atomic>
+#include <cstdint>
+
+class PerfCounters {
+public:
+    // Hardware events counted around the profiler phases.
+    enum Event { Cycles, Instructions, CacheMisses, BranchMisses, VectorInstructions, EventsCount };
+
+    // Counter values of the calling thread. Events that could not be opened stay at 0 and are not available.
+    struct Sample {
+        uint64_t values[EventsCount] = {};
+        bool available[EventsCount] = {};
+        // Tasks run by worker threads, whose events are missing from the values of the calling thread.
+        uint64_t workerTasks = 0;
+
+        // Return the counts elapsed between `start` and this sample.
+        Sample operator-(const Sample& start) const;
+    };
+
+    // Return the name of an event.
+    static const char* EventName(size_t event);
+
+    // Check if the counters are read around the profiler phases.
+    static bool Enabled() { return enabled.load(std::memory_order_relaxed); }
+
+    // Open the counters of the calling thread through perf_event_open. When the kernel refuses them,
+    // print a warning and stay disabled. Return whether the counters are enabled.
+    static bool Enable();
+
+    // Read the counters of the calling thread, opening them on its first read.
+    static Sample Read();
+
+    // Record a task run by a worker thread (ParallelFor, ThreadPool) when the counters are enabled. The counters
+    // only count the thread that opened them, so a sample during which workers ran tasks misses their events.
+    static void RecordWorkerTask() {
+        if (Enabled()) {
+            workerTasks.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+private:
+    static inline std::atomic<bool> enabled{ false };
+    static inline std::atomic<uint64_t> workerTasks{ 0 };
+};
+
+#endif // PERF_COUNTERS_H
@@ -0,0 +1,109 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include "utils.h"
+#include "tracer.h"
+#include "perf_counters.h"
+#include "memory_profiler.h"
+
+class Profiler {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // Timer recording the duration of a named phase when the profiler is enabled, and its region when the tracer is.
+    // The hardware counters of the thread and the allocations of the process are read around the phase when they
+    // are enabled, and reported per row when the phase processes `rows` rows. The counters miss the events of the
+    // worker threads, the phases during which they ran tasks are marked in the reports. Phases can nest and run on any thread. The name must be a string literal.
+    class Phase {
+    public:
+        explicit Phase(const char* name, size_t rows = 0) : name(name), rows(rows), active(Profiler::Enabled()), traced(Tracer::Enabled()) {
+            if (active) {
+                if (PerfCounters::Enabled()) {
+                    perfStart = PerfCounters::Read();
+                }
+                if (MemoryProfiler::Enabled()) {
+                    memoryStart = MemoryProfiler::Read();
+                }
+                start = Clock::now();
+            }
+            if (traced) {
+                Tracer::Begin(name);
+            }
+        }
+
+        ~Phase() {
+            Stop();
+        }
+
+        // Set the number of rows processed by the phase, when it is only known at its end.
+        void SetRows(size_t count) {
+            rows = count;
+        }
+
+        // Record the phase before the end of its scope.
+        void Stop() {
+            if (active) {
+                const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+                PerfCounters::Sample counters;
+                if (PerfCounters::Enabled()) {
+                    counters = PerfCounters::Read() - perfStart;
+                }
+                MemoryProfiler::Sample memory;
+                if (MemoryProfiler::Enabled()) {
+                    memory = MemoryProfiler::Read() - memoryStart;
+                }
+                Profiler::RecordPhase(name, seconds, rows, counters, memory);
+                active = false;
+            }
+            if (traced) {
+                Tracer::End(name);
+                traced = false;
+            }
+        }
+
+        Phase(const Phase&) = delete;
+        Phase& operator=(const Phase&) = delete;
+
+    private:
+        const char* name;
+        size_t rows;
+        bool active;
+        bool traced;
+        Clock::time_point start;
+        PerfCounters::Sample perfStart;
+        MemoryProfiler::Sample memoryStart;
+    };
+
+    // Check if the profiler records phases and counters.
+    static bool Enabled() { return enabled.load(std::memory_order_relaxed); }
+
+    // Start recording phases and counters.
+    static void Enable();
+
+    // Enable the profiler when `--profile` is given, and report on exit: a summary table on the error output,
+    // or a JSON document when a path is given with `--profile=<path>`. Also set up the tracer for `--trace`, the
+    // hardware counters for `--perf` and the allocation counts for `--memory`, which both imply `--profile`.
+    static void Setup(const CommandLine& commandLine);
+
+    // Add the duration, processed rows, hardware counts and allocations of one call of a phase.
+    static void RecordPhase(const std::string& name, double seconds, size_t rows = 0, const PerfCounters::Sample& counters = {},
+        const MemoryProfiler::Sample& memory = {});
+
+    // Add a value to a named counter (bytes_read, rows_parsed, flops...).
+    static void AddCounter(const std::string& name, double value);
+
+    // Print the phases and counters as a table.
+    static void PrintSummary(std::ostream& out);
+
+    // Write the phases and counters as a JSON document.
+    static void WriteJson(std::ostream& out);
+
+private:
+    static inline std::atomic<bool> enabled{ false };
+};
+
+#endif // PROFILER_H
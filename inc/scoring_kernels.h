@@ -0,0 +1,44 @@
+#ifndef SCORING_KERNELS_H
+#define SCORING_KERNELS_H
+
+#include <cstddef>
+#include <vector>
+
+// Scoring and gradient kernels of the one-vs-all logistic regression. Models with up to MaxSpecializedFeatures
+// features use kernels specialized on their feature count, and on SpecializedHouses houses for the predictions,
+// so that the weighted sums are fully unrolled with the weights in registers. Other models use the generic kernels.
+class ScoringKernels {
+public:
+    static constexpr size_t MaxSpecializedFeatures = 16;
+    static constexpr size_t SpecializedHouses = 4;
+
+    struct Set {
+        // Return the probability of a row given the weights of one house.
+        double (*hypothesis)(const double* weights, const double* inputs, size_t features);
+
+        // Write to `gradient` the gradient of the log-loss of a house, over every row in one pass.
+        void (*gradient)(const std::vector<std::vector<double>>& inputs, const std::vector<std::vector<double>>& targets,
+            size_t house, const double* weights, size_t features, double* gradient);
+
+        // Return the sum over the rows of the log-likelihood of a house (the log-loss times minus the row count).
+        double (*logLikelihood)(const std::vector<std::vector<double>>& inputs, const std::vector<std::vector<double>>& targets,
+            size_t house, const double* weights, size_t features);
+
+        // Write to `houses` the most probable house of the rows [begin, end), the weights of the houses being
+        // stored one after the other. The sigmoid being increasing, it is the house of the largest weighted sum,
+        // so no probability is computed.
+        void (*predict)(const std::vector<std::vector<double>>& inputs, size_t begin, size_t end, const double* weights,
+            size_t features, size_t housesCount, size_t* houses);
+
+        // Whether the kernels are specialized on the feature count.
+        bool specialized;
+    };
+
+    // Return the kernels of a model.
+    static const Set& Select(size_t features, size_t housesCount);
+
+    // Return the weights of every house one after the other, as read by Set::predict.
+    static std::vector<double> Flatten(const std::vector<std::vector<double>>& weights);
+};
+
+#endif // SCORING_KERNELS_H
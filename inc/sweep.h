@@ -0,0 +1,46 @@
+#ifndef SWEEP_H
+#define SWEEP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+#include "cross_validation.h"
+
+// Values tried for each hyperparameter.
+struct SweepSpace {
+    std::vector<double> learningRates = { 0.1 };
+    std::vector<size_t> epochs = { 100 };
+    std::vector<double> l2 = { 0.0 };
+    std::vector<Solver> solvers = { Solver::Batch };
+};
+
+// Settings of one trial of a sweep, with its scores on the held-out rows and its training time.
+struct SweepTrial {
+    TrainingSettings settings;
+    FoldResult result;
+    double seconds = 0.0;
+};
+
+class Sweep {
+public:
+    // Return every combination of the values of the space (grid search).
+    static std::vector<TrainingSettings> Grid(const SweepSpace& space);
+
+    // Draw `trials` settings within the ranges of the space (random search): learning rates and positive L2 strengths
+    // log-uniformly between their smallest and largest values, epochs uniformly, solvers among the listed ones.
+    // When 0 is one of the L2 strengths, it is drawn as often as each other listed value would be.
+    static std::vector<TrainingSettings> Sample(const SweepSpace& space, size_t trials, uint64_t seed);
+
+    // Train every setting on the training rows of the first of `holdoutFolds` folds of the matrix and score it on the
+    // validation rows, scheduling the trials on a work-stealing pool of `threadsCount` workers. The trials share the
+    // matrix and its scaling, fitted once, and the initial weights drawn from `seed`. The trials are returned by
+    // increasing validation log-loss.
+    static std::vector<SweepTrial> Run(const DesignMatrix& matrix, const std::vector<TrainingSettings>& settings,
+        size_t holdoutFolds, uint64_t seed, size_t threadsCount = 0);
+
+    // Write the trials as a JSON leaderboard, in their order.
+    static void WriteLeaderboard(const std::vector<SweepTrial>& trials, std::ostream& out);
+};
+
+#endif // SWEEP_H
@@ -0,0 +1,40 @@
+#ifndef SYNTHETIC_H
+#define SYNTHETIC_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "utils.h"
+
+// Parameters of a synthetic dataset with the `dataset_train.csv` layout.
+struct SyntheticOptions {
+    size_t rows = 1600;
+    size_t features = 13;
+    // Distance between the house clusters, in standard deviations of the course noise.
+    double separation = 2.0;
+    // Probability for a course score to be missing.
+    double nanRate = 0.0;
+    uint64_t seed = 42;
+    // Leave the house column empty, as in `dataset_test.csv`.
+    bool testSet = false;
+};
+
+class Synthetic {
+public:
+    // Number of rows generated from the same random stream. Rows only depend on the seed and on their block.
+    static constexpr size_t BlockRows = 4096;
+
+    // Return the headers of a synthetic dataset: Index, labels, then the courses.
+    static std::vector<std::string> Headers(const SyntheticOptions& options);
+
+    // Generate the students of the rows [begin, end).
+    static void GenerateStudents(const SyntheticOptions& options, size_t begin, size_t end, std::vector<StudentInfo>& students);
+
+    // Write a synthetic dataset to a CSV file, formatting blocks on all hardware threads.
+    static void WriteCsv(const std::string& filename, const SyntheticOptions& options);
+
+    // Write a synthetic dataset to a binary cache file readable by Utils::LoadDataFile.
+    static void WriteBinary(const std::string& filename, const SyntheticOptions& options);
+};
+
+#endif // SYNTHETIC_H
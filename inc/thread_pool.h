@@ -0,0 +1,59 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Pool of worker threads with one task queue each. A worker runs the newest task of its own queue, and when it is
+// empty steals the oldest task of another queue, so that tasks of uneven lengths keep every worker busy.
+class ThreadPool {
+public:
+    // Start `threadsCount` workers, one per hardware thread by default.
+    explicit ThreadPool(size_t threadsCount = 0);
+
+    // Wait for the queued tasks, then stop the workers.
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Queue a task: on the queue of the calling worker when a task submits it, else on the queues in turn.
+    void Submit(std::function<void()> task);
+
+    // Wait until every submitted task ran, rethrowing the first exception raised by one of them.
+    void Wait();
+
+    size_t size() const { return workers.size(); }
+
+private:
+    struct Worker {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+        std::thread thread;
+    };
+
+    void run(size_t index);
+
+    // Pop the newest task of the queue of a worker, or steal the oldest task of another one.
+    bool takeTask(size_t index, std::function<void()>& task);
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    // Guards the counters below, which the sleeping workers and Wait() are notified of.
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    size_t queued = 0;
+    size_t unfinished = 0;
+    size_t nextQueue = 0;
+    bool stopping = false;
+    std::exception_ptr error;
+};
+
+#endif // THREAD_POOL_H
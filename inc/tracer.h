@@ -0,0 +1,73 @@
+#ifndef TRACER_H
+#define TRACER_H
+
+#include <atomic>
+#include <iostream>
+
+struct CommandLine;
+
+class Tracer {
+public:
+    // Number of events kept per thread. Older events are overwritten when a thread records more. The events are
+    // allocated by chunks as they are recorded, and the buffer of a finished thread is reused by the next new one,
+    // so that the memory held is bounded by the threads running at once, not by the threads started.
+    static constexpr size_t EventsPerThread = 1 << 16;
+    static constexpr size_t EventsPerChunk = 1 << 10;
+
+    // Begin and end events of a named region on the calling thread, recorded when the tracer is enabled.
+    // The name must outlive the tracer, which is the case of string literals.
+    class Scope {
+    public:
+        explicit Scope(const char* name) : name(name), active(Tracer::Enabled()) {
+            if (active) {
+                Tracer::Begin(name);
+            }
+        }
+
+        ~Scope() {
+            Stop();
+        }
+
+        // Record the end event before the end of the scope.
+        void Stop() {
+            if (active) {
+                Tracer::End(name);
+                active = false;
+            }
+        }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        const char* name;
+        bool active;
+    };
+
+    // Check if the tracer records events.
+    static bool Enabled() { return enabled.load(std::memory_order_relaxed); }
+
+    // Start recording events.
+    static void Enable();
+
+    // Enable the tracer when `--trace` is given, and write the events to `trace.json`, or to the file given
+    // with `--trace=<path>`, on exit.
+    static void Setup(const CommandLine& commandLine);
+
+    // Record the beginning of a region on the calling thread.
+    static void Begin(const char* name);
+
+    // Record the end of a region on the calling thread.
+    static void End(const char* name);
+
+    // Name the calling thread in the trace.
+    static void SetThreadName(const char* name);
+
+    // Write the recorded events in the Chrome trace-event JSON format, readable by Perfetto.
+    static void WriteJson(std::ostream& out);
+
+private:
+    static inline std::atomic<bool> enabled{ false };
+};
+
+#endif // TRACER_H
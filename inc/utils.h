@@ -7,52 +7,221 @@
 #include <iomanip>
 #include <limits>
 #include <vector>
+#include <span>
 #include <functional>
+#include <thread>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <algorithm>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include "tracer.h"
+#include "perf_counters.h"
 
 struct StudentInfo {
     std::vector<std::string> labels;
     std::vector<double> features;
-    size_t index;
+    size_t index = 0;
+};
+
+// Columns parsed by the loader. The other columns are skipped while scanning for delimiters, without conversion
+// nor allocation, and the students only hold the kept columns, in the order listed here.
+struct ColumnProjection {
+    // Label columns kept, as 0-based indices among the label columns.
+    std::vector<size_t> labels;
+    // Feature columns kept, as 0-based indices among the feature columns.
+    std::vector<size_t> features;
+};
+
+// Students of a data file, with the headers of its columns.
+struct Dataset {
+    std::vector<std::string> headers;
+    size_t featuresStartIndex = 0;
+    std::vector<StudentInfo> students;
+    // Feature column of the file (0-based) held at each position of the students features.
+    std::vector<size_t> featureColumns;
+};
+
+// Feature values of students grouped by a label, stored by feature: the values of a group are one contiguous range
+// of each feature column, so that statistics and bins read every group in place.
+struct GroupedColumns {
+    size_t rows = 0;
+    // Value of feature i for the k-th grouped student at i * rows + k.
+    std::vector<double> values;
+    // Grouped students of group g are [begin[g], begin[g + 1]).
+    std::vector<size_t> begin;
+
+    // Return the values of a feature for a group.
+    std::span<const double> group(size_t feature, size_t group) const {
+        return std::span<const double>(values).subspan(feature * rows + begin[group], begin[group + 1] - begin[group]);
+    }
+
+    // Return the views of every feature of every group, indexed [group][feature].
+    std::vector<std::vector<std::span<const double>>> views() const;
+};
+
+// Command line split into positional arguments and `--name[=value]` options.
+struct CommandLine {
+    std::vector<std::string> positional;
+    std::unordered_map<std::string, std::string> options;
+
+    // Check if an option was given.
+    bool has(const std::string& name) const;
+
+    // Return the value of an option, or `fallback` when it was not given.
+    std::string get(const std::string& name, const std::string& fallback = "") const;
+
+    // Return the numeric value of an option, or `fallback` when it was not given.
+    double getNumber(const std::string& name, double fallback) const;
+
+    // Return the value of an option holding a whole number of at most `max`, or `fallback` when it was not given.
+    uint64_t getCount(const std::string& name, uint64_t fallback, uint64_t max = std::numeric_limits<uint64_t>::max()) const;
+
+    // Return the comma-separated values of an option, or `fallback` when it was not given.
+    std::vector<std::string> getList(const std::string& name, const std::vector<std::string>& fallback) const;
+
+    // Return the comma-separated numeric values of an option, or `fallback` when it was not given.
+    std::vector<double> getNumbers(const std::string& name, const std::vector<double>& fallback) const;
 };
 
 class Utils {
 public:
+    // Magic bytes of the binary cache files. After them come the row count (uint64), the headers count (uint32),
+    // the features start index (uint32) and the headers, then for each row its index (uint64), its labels and its
+    // features (double). Strings are prefixed by their length (uint32) and values use the native byte order.
+    static constexpr const char* BinaryCacheMagic = "DSLRBIN1";
+
     // Check if a string represents a number.
-    static bool isNumber(const std::string& str);
+    static bool isNumber(std::string_view str);
+
+    // Parse a non-negative whole number of at most `max` into `value`. Return false, leaving `value` unchanged, when
+    // `text` holds anything else: a sign, a fraction, an exponent or a number out of range.
+    static bool ParseCount(std::string_view text, uint64_t max, uint64_t& value);
 
-    // Load data from a file, including headers, features start index, and student information.
-    static std::pair<std::vector<std::string>, size_t> LoadDataFile(const std::string& filename, std::vector<StudentInfo>& students);
+    // Split the command line arguments. Options listed in `valueOptions` also accept their value as the next argument.
+    static CommandLine ParseCommandLine(int argc, char* argv[], const std::vector<std::string>& valueOptions = {});
+
+    // Load data from a CSV file or a binary cache, including headers, features start index, and student information.
+    // Only the columns of `projection` are parsed when one is given.
+    static std::pair<std::vector<std::string>, size_t> LoadDataFile(const std::string& filename, std::vector<StudentInfo>& students,
+        const ColumnProjection* projection = nullptr);
+
+    // Load a data file like LoadDataFile, handing its students to `consume` by chunks of at most `chunkRows` rows,
+    // so that only one chunk is held as students at once. `consume` may move the students out of the chunk.
+    static std::pair<std::vector<std::string>, size_t> LoadDataFileChunks(const std::string& filename, size_t chunkRows,
+        const std::function<void(std::vector<StudentInfo>&)>& consume, const ColumnProjection* projection = nullptr);
+
+    // Load the data lines of a CSV file starting at byte `offset`, or after the header when it is before, and return
+    // the offset following the last complete line, from which the next call can resume once lines were appended.
+    // A last line without its newline is not loaded, since it may still be written. The features start index is
+    // determined from the first lines of the file when `featuresStartIndex` is 0.
+    static size_t LoadDataTail(const std::string& filename, size_t offset, std::vector<std::string>& headers, size_t& featuresStartIndex,
+        std::vector<StudentInfo>& students);
+
+    // Expand a comma-separated list of data files and glob patterns (`part-*.csv`) into file paths,
+    // keeping the order of the list and sorting the matches of each pattern.
+    static std::vector<std::string> ExpandDataFiles(const std::string& filenames);
+
+    // Load whole data files into a dataset, throwing when it holds no student. `filenames` is expanded by
+    // ExpandDataFiles, and the shards, which must share their header, are parsed concurrently then appended in order.
+    // Only the columns of `projection` are parsed when one is given.
+    static Dataset LoadDataset(const std::string& filenames, const ColumnProjection* projection = nullptr);
+
+    // Return copies of the students holding only the given feature columns (0-based indices of the file), in that
+    // order, and their labels when `keepLabels` is set. Throw when a column was not loaded.
+    static std::vector<StudentInfo> SelectFeatures(const Dataset& dataset, const std::vector<size_t>& featureColumns, bool keepLabels);
+
+    // Group the students whose label `labelIndex` is one of `groups`, in the order of `groups` then of the students.
+    static GroupedColumns GroupFeatures(const std::vector<StudentInfo>& students, size_t labelIndex, const std::vector<std::string>& groups);
 
     // Execute a system command and print an error message if the execution fails.
     static void executeCommand(const std::string& command);
 
     // Print feature headers with a specified maximum width.
-    static void printFeatureHeader(const size_t max);
+    static void printFeatureHeader(const size_t max, std::ostream& out = std::cout);
 
-    // Display section name and computed features with fixed precision.
-    template <typename Function>
-    static void computeAndPrintFeatures(const std::string& sectionName, Function function, std::vector<std::vector<double>> featuresValues) {
+    // Display section name and computed features with fixed precision. `featuresValues` is any range of columns
+    // (vectors, spans, views), read in place.
+    template <typename Function, typename Columns>
+    static void computeAndPrintFeatures(const std::string& sectionName, Function&& function, const Columns& featuresValues,
+        std::ostream& out = std::cout) {
         const int fieldWidth = 14; // Output field width.
 
         // Print section name and computed features.
-        std::cout << std::setw(fieldWidth) << std::left << sectionName;
+        out << std::setw(fieldWidth) << std::left << sectionName;
         for (const auto& value : featuresValues) {
-            std::cout << std::setw(fieldWidth) << std::right << std::fixed << std::setprecision(6) << function(value);
+            out << std::setw(fieldWidth) << std::right << std::fixed << std::setprecision(6) << function(value);
+        }
+        out << std::endl;
+    }
+
+    // Run function(i) for every i in [0, count) on all hardware threads, rethrowing the first exception raised.
+    template <typename Function>
+    static void ParallelFor(size_t count, Function function) {
+        const size_t threadsCount = std::min<size_t>(count, std::max(1u, std::thread::hardware_concurrency()));
+        std::atomic<size_t> next(0);
+        std::exception_ptr error;
+        std::mutex errorMutex;
+
+        // Each worker claims the next index until none is left. The indices run by the spawned threads are recorded,
+        // since the hardware counters of the calling thread miss them.
+        auto worker = [&](bool spawned) {
+            Tracer::Scope scope("ParallelFor.worker");
+            for (size_t i = next++; i < count; i = next++) {
+                if (spawned) {
+                    PerfCounters::RecordWorkerTask();
+                }
+                try {
+                    function(i);
+                }
+                catch (...) {
+                    std::lock_guard<std::mutex> lock(errorMutex);
+                    if (!error) {
+                        error = std::current_exception();
+                    }
+                }
+            }
+        };
+
+        std::vector<std::thread> threads;
+        for (size_t t = 1; t < threadsCount; ++t) {
+            threads.emplace_back(worker, true);
+        }
+        worker(false);
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        if (error) {
+            std::rethrow_exception(error);
         }
-        std::cout << std::endl;
     }
 
     static void NormalizeData(std::vector<StudentInfo>& data, std::vector<double>& featureMeans, std::vector<double>& featureStdDevs);
 
+    // Save the models with the normalization parameters and the indices (1-based) of the features they use, and the
+    // number of rows the normalization was computed on when known. The file is written then renamed over the previous one.
     static void SaveWeightsAndNormalizationParameters(const std::vector<std::vector<double>>& weights,
         const std::vector<double>& featureMeans,
         const std::vector<double>& featureStdDevs,
-        const std::string& filename);
+        const std::vector<size_t>& selectedFeatures,
+        const std::string& filename,
+        size_t normalizationRows = 0);
 
+    // Load the models saved by SaveWeightsAndNormalizationParameters. Files written before the features were saved
+    // hold the parameters of every feature: they are reduced to the features 3, 4 and 7 they were trained on.
+    // `normalizationRows` receives 0 when the file does not record it.
     static void LoadWeightsAndNormalizationParameters(std::vector<std::vector<double>>& weights,
         std::vector<double>& featureMeans,
         std::vector<double>& featureStdDevs,
-        const std::string& filename);
+        std::vector<size_t>& selectedFeatures,
+        const std::string& filename,
+        size_t* normalizationRows = nullptr);
+
+    // Return the indices (1-based) of the features used by a model file.
+    static std::vector<size_t> LoadSelectedFeatures(const std::string& filename);
 };
 
 #endif // UTILS_H
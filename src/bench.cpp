@@ -0,0 +1,274 @@
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <string>
+#include <vector>
+#include "utils.h"
+#include "calculate.h"
+#include "feature_column.h"
+#include "logreg.h"
+#include "scoring_kernels.h"
+#include "synthetic.h"
+
+// Parameters of one synthetic dataset.
+struct BenchmarkDataset {
+    size_t rows;
+    size_t features;
+    double nanRate;
+};
+
+// Timing of one benchmark over one dataset.
+struct BenchmarkResult {
+    std::string name;
+    BenchmarkDataset dataset;
+    size_t iterations;
+    double nsPerIteration;
+    double rowsPerIteration;
+    double bytesPerIteration;
+};
+
+// Sink preventing the compiler from discarding benchmarked results.
+static volatile double sink = 0;
+
+// Function to run a benchmark until it lasted at least `minSeconds`, returning the mean iteration time in nanoseconds.
+template <typename Function>
+std::pair<size_t, double> measure(Function function, double minSeconds)
+{
+    using Clock = std::chrono::steady_clock;
+
+    // Warm up caches and lazy allocations.
+    function();
+
+    size_t iterations = 0;
+    const auto start = Clock::now();
+    std::chrono::duration<double> elapsed(0);
+    do {
+        function();
+        iterations++;
+        elapsed = Clock::now() - start;
+    } while (elapsed.count() < minSeconds);
+
+    return { iterations, std::chrono::duration<double, std::nano>(elapsed).count() / static_cast<double>(iterations) };
+}
+
+// Function to split a comma-separated list of numbers.
+std::vector<double> parseList(const std::string& list)
+{
+    std::vector<double> values;
+    std::istringstream stream(list);
+    std::string element;
+    while (std::getline(stream, element, ',')) {
+        values.push_back(std::stod(element));
+    }
+    return values;
+}
+
+// Function to run every benchmark over one dataset.
+void runBenchmarks(const BenchmarkDataset& dataset, double minSeconds, std::vector<BenchmarkResult>& results)
+{
+    const double rows = static_cast<double>(dataset.rows);
+    const double columnBytes = rows * sizeof(double);
+    auto record = [&](const std::string& name, std::pair<size_t, double> timing, double rowsPerIteration, double bytesPerIteration) {
+        results.push_back({ name, dataset, timing.first, timing.second, rowsPerIteration, bytesPerIteration });
+        std::cerr << "  " << std::left << std::setw(28) << name << std::right << std::setw(14) << std::fixed << std::setprecision(1) << timing.second << " ns/iter" << std::endl;
+    };
+
+    SyntheticOptions options;
+    options.rows = dataset.rows;
+    options.features = dataset.features;
+    options.nanRate = dataset.nanRate;
+
+    std::vector<std::string> headers = Synthetic::Headers(options);
+    std::vector<StudentInfo> students;
+    Synthetic::GenerateStudents(options, 0, options.rows, students);
+
+    // Loader over a CSV file written once.
+    const std::string path = (std::filesystem::temp_directory_path() / "dslr_bench.csv").string();
+    Synthetic::WriteCsv(path, options);
+    const double fileBytes = static_cast<double>(std::filesystem::file_size(path));
+    record("LoadDataFile", measure([&]() {
+        std::vector<StudentInfo> loaded;
+        Utils::LoadDataFile(path, loaded);
+        sink = static_cast<double>(loaded.size());
+    }, minSeconds), rows, fileBytes);
+
+    // Cell parsing, over the textual cells of the feature columns.
+    std::vector<std::string> cells;
+    double cellsBytes = 0;
+    {
+        std::ostringstream cell;
+        cell << std::setprecision(10);
+        for (const auto& student : students) {
+            for (double feature : student.features) {
+                cell.str("");
+                if (!std::isnan(feature)) {
+                    cell << feature;
+                }
+                cells.push_back(cell.str());
+                cellsBytes += static_cast<double>(cells.back().size());
+            }
+        }
+    }
+    record("isNumber", measure([&]() {
+        size_t numbers = 0;
+        for (const auto& cell : cells) {
+            numbers += Utils::isNumber(cell);
+        }
+        sink = static_cast<double>(numbers);
+    }, minSeconds), rows, cellsBytes);
+    record("isNumber+stod", measure([&]() {
+        double sum = 0;
+        for (const auto& cell : cells) {
+            if (Utils::isNumber(cell)) {
+                sum += std::stod(cell);
+            }
+        }
+        sink = sum;
+    }, minSeconds), rows, cellsBytes);
+
+    // Calculate kernels over the first two feature columns.
+    std::vector<std::vector<double>> columns(std::min<size_t>(dataset.features, 2));
+    for (size_t j = 0; j < columns.size(); ++j) {
+        for (const auto& student : students) {
+            columns[j].push_back(student.features[j]);
+        }
+    }
+    const auto& column = columns[0];
+    const auto& other = columns.back();
+    record("Calculate::Mean", measure([&]() { sink = Calculate::Mean(column); }, minSeconds), rows, columnBytes);
+    record("Calculate::StandardDeviation", measure([&]() { sink = Calculate::StandardDeviation(column); }, minSeconds), rows, columnBytes);
+    record("Calculate::Min", measure([&]() { sink = Calculate::Min(column); }, minSeconds), rows, columnBytes);
+    record("Calculate::Max", measure([&]() { sink = Calculate::Max(column); }, minSeconds), rows, columnBytes);
+    record("Calculate::Quartile", measure([&]() { sink = Calculate::Quartile(column, 25); }, minSeconds), rows, columnBytes);
+    record("Calculate::Covariance", measure([&]() { sink = Calculate::Covariance(column, other); }, minSeconds), rows, 2 * columnBytes);
+    record("Calculate::PearsonCorrelation", measure([&]() { sink = Calculate::PearsonCorrelation(column, other); }, minSeconds), rows, 2 * columnBytes);
+
+    // Same reductions over the column with its validity bitmap.
+    FeatureColumn bitmapColumn;
+    for (double value : column) {
+        bitmapColumn.push_back(value);
+    }
+    record("Calculate::Mean(FeatureColumn)", measure([&]() { sink = Calculate::Mean(bitmapColumn); }, minSeconds), rows, columnBytes);
+    record("Calculate::StandardDeviation(FeatureColumn)", measure([&]() { sink = Calculate::StandardDeviation(bitmapColumn); }, minSeconds), rows, columnBytes);
+    record("Calculate::Min(FeatureColumn)", measure([&]() { sink = Calculate::Min(bitmapColumn); }, minSeconds), rows, columnBytes);
+    record("Calculate::Max(FeatureColumn)", measure([&]() { sink = Calculate::Max(bitmapColumn); }, minSeconds), rows, columnBytes);
+
+    // Training and scoring over the preprocessed selected features.
+    std::vector<size_t> selectedFeatures;
+    for (size_t feature : { 3, 4, 7 }) {
+        if (feature <= dataset.features) {
+            selectedFeatures.push_back(feature);
+        }
+    }
+    if (selectedFeatures.empty()) {
+        selectedFeatures.push_back(1);
+    }
+    const double inputBytes = rows * static_cast<double>(selectedFeatures.size()) * sizeof(double);
+
+    std::vector<double> featureMeans, featureStdDevs;
+    LogisticRegression::HandleMissingValues(students);
+    Utils::NormalizeData(students, featureMeans, featureStdDevs);
+
+    const size_t housesCount = LogisticRegression::HousesIndex.size();
+    std::vector<std::vector<double>> weights(housesCount, std::vector<double>(selectedFeatures.size(), 0.0));
+    std::vector<std::vector<double>> inputs, targets;
+    LogisticRegression::SetupTrainingData(students, selectedFeatures, LogisticRegression::HousesIndex, weights, inputs, targets);
+
+    record("Calculate::LogisticRegressionHypothesis", measure([&]() {
+        double sum = 0;
+        for (const auto& input : inputs) {
+            sum += Calculate::LogisticRegressionHypothesis(weights[0], input);
+        }
+        sink = sum;
+    }, minSeconds), rows, inputBytes);
+    record("Calculate::Accuracy", measure([&]() { sink = Calculate::Accuracy(inputs, targets, weights); }, minSeconds), rows, inputBytes);
+
+
+    // Selected kernels of the model, then the generic ones they replace.
+    const size_t featuresCount = selectedFeatures.size();
+    const std::vector<double> flatWeights = ScoringKernels::Flatten(weights);
+    std::vector<double> gradient(featuresCount);
+    std::vector<size_t> predictedHouses(inputs.size());
+    for (const auto* kernels : { &ScoringKernels::Select(featuresCount, housesCount), &ScoringKernels::Select(0, 0) }) {
+        const std::string variant = kernels->specialized ? "" : " (generic)";
+        record("ScoringKernels::gradient" + variant, measure([&]() {
+            kernels->gradient(inputs, targets, 0, flatWeights.data(), featuresCount, gradient.data());
+            sink = gradient[0];
+        }, minSeconds), rows, inputBytes);
+        record("ScoringKernels::predict" + variant, measure([&]() {
+            kernels->predict(inputs, 0, inputs.size(), flatWeights.data(), featuresCount, housesCount, predictedHouses.data());
+            sink = static_cast<double>(predictedHouses[0]);
+        }, minSeconds), rows, inputBytes);
+    }
+
+    std::ostream nullStream(nullptr);
+    record("trainModels epoch", measure([&]() {
+        auto epochWeights = weights;
+        LogisticRegression::TrainModels(epochWeights, inputs, targets, 1, nullStream);
+        sink = epochWeights[0][0];
+    }, minSeconds), rows, inputBytes);
+
+    const std::string outputPath = (std::filesystem::temp_directory_path() / "dslr_bench_houses.csv").string();
+    record("performPredictions", measure([&]() {
+        LogisticRegression::PerformPredictions(students, weights, headers, inputs, outputPath);
+    }, minSeconds), rows, inputBytes);
+
+    std::filesystem::remove(path);
+    std::filesystem::remove(outputPath);
+}
+
+// Function to print the results as a JSON document.
+void printResults(const std::vector<BenchmarkResult>& results)
+{
+    std::cout << "{\n  \"benchmarks\": [";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const auto& result = results[i];
+        const double seconds = result.nsPerIteration * 1e-9;
+        std::cout << (i ? "," : "") << "\n    {"
+            << "\"name\": \"" << result.name << "\", "
+            << "\"rows\": " << result.dataset.rows << ", "
+            << "\"features\": " << result.dataset.features << ", "
+            << "\"nan_rate\": " << result.dataset.nanRate << ", "
+            << "\"iterations\": " << result.iterations << ", "
+            << "\"ns_per_iteration\": " << result.nsPerIteration << ", "
+            << "\"ns_per_row\": " << result.nsPerIteration / result.rowsPerIteration << ", "
+            << "\"rows_per_second\": " << result.rowsPerIteration / seconds << ", "
+            << "\"gigabytes_per_second\": " << result.bytesPerIteration / seconds * 1e-9
+            << "}";
+    }
+    std::cout << "\n  ]\n}" << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+    try {
+        CommandLine commandLine = Utils::ParseCommandLine(argc, argv, { "rows", "features", "nan", "min-time" });
+        if (!commandLine.positional.empty()) {
+            std::cerr << "Usage: " << argv[0] << " [--rows=1000,100000] [--features=13] [--nan=0,0.05] [--min-time=0.2]" << std::endl;
+            return 1;
+        }
+
+        std::vector<double> rowsList = parseList(commandLine.get("rows", "1000,100000"));
+        std::vector<double> featuresList = parseList(commandLine.get("features", "13"));
+        std::vector<double> nanRates = parseList(commandLine.get("nan", "0,0.05"));
+        double minSeconds = commandLine.getNumber("min-time", 0.2);
+
+        std::vector<BenchmarkResult> results;
+        for (double rows : rowsList) {
+            for (double features : featuresList) {
+                for (double nanRate : nanRates) {
+                    BenchmarkDataset dataset = { static_cast<size_t>(rows), static_cast<size_t>(features), nanRate };
+                    std::cerr << "rows=" << dataset.rows << " features=" << dataset.features << " nan=" << dataset.nanRate << std::endl;
+                    runBenchmarks(dataset, minSeconds, results);
+                }
+            }
+        }
+
+        printResults(results);
+    }
+    catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    return 0;
+}
@@ -0,0 +1,204 @@
+#include "binning.h"
+#include "utils.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+namespace {
+
+// Number of values whose bins are computed at once, small enough to stay in L1.
+const size_t BlockSize = 256;
+
+// Number of interleaved partial histograms used to hide store-to-load dependencies on hot bins.
+const size_t PartialHistograms = 4;
+
+// Function to compute the bin of each value of a block. NaN values are sent to the overflow bin `bins`.
+// The loop is branch-free so that the compiler can vectorize it.
+void computeBins(const double* values, size_t count, double min, double scale, size_t bins, uint32_t* out) {
+    const double last = static_cast<double>(bins - 1);
+    const double overflow = static_cast<double>(bins);
+
+    for (size_t k = 0; k < count; ++k) {
+        double position = (values[k] - min) * scale;
+        position = position < 0.0 ? 0.0 : position;
+        position = position > last ? last : position;
+        position = values[k] == values[k] ? position : overflow;
+        out[k] = static_cast<uint32_t>(position);
+    }
+}
+
+// Function to accumulate block bins into interleaved partial histograms of `slots` entries each.
+void countBins(const uint32_t* binsIndices, size_t count, size_t slots, std::vector<size_t>& partials) {
+    size_t k = 0;
+    for (; k + PartialHistograms <= count; k += PartialHistograms) {
+        for (size_t p = 0; p < PartialHistograms; ++p) {
+            partials[p * slots + binsIndices[k + p]]++;
+        }
+    }
+    for (; k < count; ++k) {
+        partials[binsIndices[k]]++;
+    }
+}
+
+// Function to merge the partial histograms, dropping the overflow slot of NaN values.
+std::vector<size_t> mergePartials(const std::vector<size_t>& partials, size_t slots) {
+    std::vector<size_t> counts(slots - 1, 0);
+    for (size_t p = 0; p < PartialHistograms; ++p) {
+        for (size_t b = 0; b + 1 < slots; ++b) {
+            counts[b] += partials[p * slots + b];
+        }
+    }
+    return counts;
+}
+
+// Function to compute the scale mapping [min, max] onto [0, bins].
+double binScale(double min, double max, size_t bins) {
+    return max > min ? static_cast<double>(bins) / (max - min) : 0.0;
+}
+
+// Function to find the range of the valid values of every group of a feature.
+std::pair<double, double> featureRange(const Binning::GroupViews& valuesByGroup, size_t feature) {
+    double min = std::numeric_limits<double>::infinity();
+    double max = -std::numeric_limits<double>::infinity();
+
+    for (const auto& group : valuesByGroup) {
+        for (double value : group[feature]) {
+            min = std::min(min, value);
+            max = std::max(max, value);
+        }
+    }
+
+    if (min > max) {
+        return { 0.0, 0.0 };
+    }
+    return { min, max };
+}
+
+} // namespace
+
+size_t Binning::FreedmanDiaconisBinCount(std::span<const double> data) {
+    std::vector<double> values;
+    values.reserve(data.size());
+    for (double value : data) {
+        if (!std::isnan(value)) {
+            values.push_back(value);
+        }
+    }
+
+    if (values.size() < 2) {
+        return 1;
+    }
+
+    const auto [minIt, maxIt] = std::minmax_element(values.begin(), values.end());
+    const double range = *maxIt - *minIt;
+
+    auto quantile = [&values](double q) {
+        auto nth = values.begin() + static_cast<std::ptrdiff_t>(q * static_cast<double>(values.size() - 1));
+        std::nth_element(values.begin(), nth, values.end());
+        return *nth;
+    };
+    const double iqr = quantile(0.75) - quantile(0.25);
+    const double width = 2.0 * iqr / std::cbrt(static_cast<double>(values.size()));
+
+    // Fall back on the square-root rule when the interquartile range is degenerate.
+    size_t bins = width > 0.0 ? static_cast<size_t>(std::ceil(range / width)) : static_cast<size_t>(std::sqrt(static_cast<double>(values.size())));
+    return std::clamp<size_t>(bins, 1, MaxAutomaticBins);
+}
+
+Histogram1D Binning::Histogram(std::span<const double> data, size_t bins, double min, double max) {
+    bins = std::max<size_t>(bins, 1);
+
+    const size_t slots = bins + 1;
+    const double scale = binScale(min, max, bins);
+    std::vector<size_t> partials(PartialHistograms * slots, 0);
+    uint32_t binsIndices[BlockSize];
+
+    for (size_t start = 0; start < data.size(); start += BlockSize) {
+        const size_t count = std::min(BlockSize, data.size() - start);
+        computeBins(data.data() + start, count, min, scale, bins, binsIndices);
+        countBins(binsIndices, count, slots, partials);
+    }
+
+    return { min, max, mergePartials(partials, slots) };
+}
+
+Histogram2D Binning::Density(std::span<const double> dataX, std::span<const double> dataY, size_t bins,
+    double xMin, double xMax, double yMin, double yMax) {
+    bins = std::max<size_t>(bins, 1);
+
+    const size_t cells = bins * bins;
+    const size_t slots = cells + 1;
+    const double xScale = binScale(xMin, xMax, bins);
+    const double yScale = binScale(yMin, yMax, bins);
+    const size_t size = std::min(dataX.size(), dataY.size());
+    std::vector<size_t> partials(PartialHistograms * slots, 0);
+    uint32_t xIndices[BlockSize];
+    uint32_t yIndices[BlockSize];
+
+    for (size_t start = 0; start < size; start += BlockSize) {
+        const size_t count = std::min(BlockSize, size - start);
+        computeBins(dataX.data() + start, count, xMin, xScale, bins, xIndices);
+        computeBins(dataY.data() + start, count, yMin, yScale, bins, yIndices);
+
+        // Combine both axes into a cell index, sending pairs with a NaN value to the overflow cell.
+        for (size_t k = 0; k < count; ++k) {
+            const bool missing = xIndices[k] == bins || yIndices[k] == bins;
+            xIndices[k] = missing ? static_cast<uint32_t>(cells) : static_cast<uint32_t>(yIndices[k] * bins + xIndices[k]);
+        }
+        countBins(xIndices, count, slots, partials);
+    }
+
+    return { xMin, xMax, yMin, yMax, bins, bins, mergePartials(partials, slots) };
+}
+
+std::vector<std::vector<Histogram1D>> Binning::HistogramsByGroup(const GroupViews& valuesByGroup, size_t bins) {
+    const size_t featuresCount = valuesByGroup.empty() ? 0 : valuesByGroup[0].size();
+    std::vector<std::vector<Histogram1D>> histograms(featuresCount);
+
+    Utils::ParallelFor(featuresCount, [&](size_t feature) {
+        const auto [min, max] = featureRange(valuesByGroup, feature);
+
+        size_t featureBins = bins;
+        if (featureBins == 0) {
+            std::vector<double> values;
+            for (const auto& group : valuesByGroup) {
+                values.insert(values.end(), group[feature].begin(), group[feature].end());
+            }
+            featureBins = FreedmanDiaconisBinCount(values);
+        }
+
+        for (const auto& group : valuesByGroup) {
+            histograms[feature].push_back(Histogram(group[feature], featureBins, min, max));
+        }
+    });
+
+    return histograms;
+}
+
+std::vector<std::vector<Histogram2D>> Binning::DensityGridsByGroup(const GroupViews& valuesByGroup, size_t bins) {
+    const size_t featuresCount = valuesByGroup.empty() ? 0 : valuesByGroup[0].size();
+
+    std::vector<std::pair<double, double>> ranges(featuresCount);
+    Utils::ParallelFor(featuresCount, [&](size_t feature) {
+        ranges[feature] = featureRange(valuesByGroup, feature);
+    });
+
+    std::vector<std::pair<size_t, size_t>> pairs;
+    for (size_t i = 0; i < featuresCount; ++i) {
+        for (size_t j = i + 1; j < featuresCount; ++j) {
+            pairs.emplace_back(i, j);
+        }
+    }
+
+    std::vector<std::vector<Histogram2D>> grids(pairs.size());
+    Utils::ParallelFor(pairs.size(), [&](size_t pair) {
+        const auto [i, j] = pairs[pair];
+        for (const auto& group : valuesByGroup) {
+            grids[pair].push_back(Density(group[i], group[j], bins,
+                ranges[i].first, ranges[i].second, ranges[j].first, ranges[j].second));
+        }
+    });
+
+    return grids;
+}
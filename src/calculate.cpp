@@ -1,36 +1,152 @@
 #include "calculate.h"
+#include "feature_column.h"
+#include "scoring_kernels.h"
+#include "tracer.h"
 #include <algorithm>
+#include <bit>
 #include <cmath>
 #include <limits>
 
-double Calculate::Mean(const std::vector<double>& data) {
+namespace {
+
+// Running sum with Neumaier compensation: the low-order bits lost by each addition are kept in `compensation`,
+// so that long columns (and floats widened to doubles) are summed to within one rounding of the exact result.
+struct CompensatedSum {
     double sum = 0.0;
+    double compensation = 0.0;
+
+    void add(double value) {
+        const double total = sum + value;
+        compensation += std::abs(sum) >= std::abs(value) ? (sum - total) + value : (value - total) + sum;
+        sum = total;
+    }
+
+    void add(const CompensatedSum& other) {
+        add(other.sum);
+        compensation += other.compensation;
+    }
+
+    double value() const { return sum + compensation; }
+};
+
+// Function to visit the blocks of a column holding values, decoded when the column is compressed:
+// full(values, count) for the fully valid ones, partial(values, count, validity) for the ones holding missing rows.
+template <typename Full, typename Partial>
+void forEachBlock(const FeatureColumn& column, Full full, Partial partial) {
+    double buffer[FeatureColumn::BlockSize];
+    for (size_t block = 0; block < column.validity.size(); ++block) {
+        const size_t count = std::min(FeatureColumn::BlockSize, column.size() - block * FeatureColumn::BlockSize);
+        const uint64_t validity = column.validity[block];
+        if (validity == 0) {
+            continue;
+        }
+        const double* values = column.block(block, buffer);
+        if (validity == (count == FeatureColumn::BlockSize ? ~0ull : (1ull << count) - 1)) {
+            full(values, count);
+        }
+        else {
+            partial(values, count, validity);
+        }
+    }
+}
+
+// Function to reduce the transformed valid values of a column over four independent lanes, `identity` standing
+// in for the missing rows. Full blocks are reduced as is, the other ones select with their validity bits.
+template <typename Transform, typename Combine>
+double reduceValid(const FeatureColumn& column, double identity, Transform transform, Combine combine) {
+    double lanes[4] = { identity, identity, identity, identity };
+    forEachBlock(column,
+        [&](const double* values, size_t count) {
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4) {
+                for (size_t lane = 0; lane < 4; ++lane) {
+                    lanes[lane] = combine(lanes[lane], transform(values[i + lane]));
+                }
+            }
+            for (; i < count; ++i) {
+                lanes[0] = combine(lanes[0], transform(values[i]));
+            }
+        },
+        [&](const double* values, size_t count, uint64_t validity) {
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4) {
+                for (size_t lane = 0; lane < 4; ++lane) {
+                    const bool valid = (validity >> (i + lane)) & 1;
+                    lanes[lane] = combine(lanes[lane], valid ? transform(values[i + lane]) : identity);
+                }
+            }
+            for (; i < count; ++i) {
+                const bool valid = (validity >> i) & 1;
+                lanes[0] = combine(lanes[0], valid ? transform(values[i]) : identity);
+            }
+        });
+    return combine(combine(lanes[0], lanes[1]), combine(lanes[2], lanes[3]));
+}
+
+// Function to sum the transformed valid values of a column over four independent compensated lanes.
+template <typename Transform>
+double sumValid(const FeatureColumn& column, Transform transform) {
+    CompensatedSum lanes[4];
+    forEachBlock(column,
+        [&](const double* values, size_t count) {
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4) {
+                for (size_t lane = 0; lane < 4; ++lane) {
+                    lanes[lane].add(transform(values[i + lane]));
+                }
+            }
+            for (; i < count; ++i) {
+                lanes[0].add(transform(values[i]));
+            }
+        },
+        [&](const double* values, size_t, uint64_t validity) {
+            for (; validity != 0; validity &= validity - 1) {
+                const size_t i = static_cast<size_t>(std::countr_zero(validity));
+                lanes[i % 4].add(transform(values[i]));
+            }
+        });
+    lanes[0].add(lanes[1]);
+    lanes[2].add(lanes[3]);
+    lanes[0].add(lanes[2]);
+    return lanes[0].value();
+}
+
+} // namespace
+
+double Calculate::Mean(StridedView data) {
+    Tracer::Scope scope("Calculate::Mean");
+    CompensatedSum sum;
     double count = 0;
-    for (const auto& value : data) {
+    for (size_t i = 0; i < data.size; ++i) {
+        const double value = data[i];
         if (!std::isnan(value)) {
-            sum += value;
+            sum.add(value);
             count++;
         }
     }
-    return sum / count;
+    return sum.value() / count;
 }
 
-double Calculate::StandardDeviation(const std::vector<double>& data) {
+double Calculate::StandardDeviation(StridedView data) {
+    Tracer::Scope scope("Calculate::StandardDeviation");
     double m = Calculate::Mean(data);
-    double variance = 0.0;
+    CompensatedSum variance;
     double count = 0;
-    for (const auto& value : data) {
+    for (size_t i = 0; i < data.size; ++i) {
+        const double value = data[i];
         if (!std::isnan(value)) {
-            variance += std::pow(value - m, 2);
+            variance.add((value - m) * (value - m));
             count++;
         }
     }
-    return std::sqrt(variance / count);
+    return std::sqrt(variance.value() / count);
 }
 
-double Calculate::Min(const std::vector<double>& data) {
+double Calculate::Min(StridedView data) {
+    Tracer::Scope scope("Calculate::Min");
     double minValue = data[0];
-    for (const auto& value : data) {
+    for (size_t i = 0; i < data.size; ++i) {
+        const double value = data[i];
         if (!std::isnan(value) && value < minValue) {
             minValue = value;
         }
@@ -38,9 +154,11 @@ double Calculate::Min(const std::vector<double>& data) {
     return minValue;
 }
 
-double Calculate::Max(const std::vector<double>& data) {
+double Calculate::Max(StridedView data) {
+    Tracer::Scope scope("Calculate::Max");
     double maxValue = data[0];
-    for (const auto& value : data) {
+    for (size_t i = 0; i < data.size; ++i) {
+        const double value = data[i];
         if (!std::isnan(value) && value > maxValue) {
             maxValue = value;
         }
@@ -48,6 +166,53 @@ double Calculate::Max(const std::vector<double>& data) {
     return maxValue;
 }
 
+double Calculate::Count(const FeatureColumn& column) {
+    return static_cast<double>(column.count());
+}
+
+double Calculate::Mean(const FeatureColumn& column) {
+    Tracer::Scope scope("Calculate::Mean");
+    const double sum = sumValid(column, [](double value) { return value; });
+    return sum / static_cast<double>(column.count());
+}
+
+double Calculate::StandardDeviation(const FeatureColumn& column) {
+    Tracer::Scope scope("Calculate::StandardDeviation");
+    const double m = Calculate::Mean(column);
+    auto squaredDeviation = [m](double value) { return (value - m) * (value - m); };
+    const double variance = sumValid(column, squaredDeviation);
+    return std::sqrt(variance / static_cast<double>(column.count()));
+}
+
+double Calculate::Min(const FeatureColumn& column) {
+    Tracer::Scope scope("Calculate::Min");
+    const double minValue = reduceValid(column, std::numeric_limits<double>::infinity(),
+        [](double value) { return value; }, [](double a, double b) { return std::min(a, b); });
+    return column.count() ? minValue : std::numeric_limits<double>::quiet_NaN();
+}
+
+double Calculate::Max(const FeatureColumn& column) {
+    Tracer::Scope scope("Calculate::Max");
+    const double maxValue = reduceValid(column, -std::numeric_limits<double>::infinity(),
+        [](double value) { return value; }, [](double a, double b) { return std::max(a, b); });
+    return column.count() ? maxValue : std::numeric_limits<double>::quiet_NaN();
+}
+
+double Calculate::Quartile(const FeatureColumn& column, int n) {
+    std::vector<double> validValues;
+    validValues.reserve(column.count());
+    forEachBlock(column,
+        [&](const double* values, size_t count) {
+            validValues.insert(validValues.end(), values, values + count);
+        },
+        [&](const double* values, size_t, uint64_t validity) {
+            for (; validity != 0; validity &= validity - 1) {
+                validValues.push_back(values[std::countr_zero(validity)]);
+            }
+        });
+    return Calculate::Quartile(validValues, n);
+}
+
 void swap(double& a, double& b) {
     double temp = a;
     a = b;
@@ -82,9 +247,11 @@ void quickSort(std::vector<double>& arr, int low, int high) {
     }
 }
 
-double Calculate::Quartile(const std::vector<double>& data, int n) {
+double Calculate::Quartile(StridedView data, int n) {
+    Tracer::Scope scope("Calculate::Quartile");
     std::vector<double> sortedData;
-    for (const auto& value : data) {
+    for (size_t i = 0; i < data.size; ++i) {
+        const double value = data[i];
         if (!std::isnan(value)) {
             sortedData.push_back(value);
         }
@@ -95,25 +262,27 @@ double Calculate::Quartile(const std::vector<double>& data, int n) {
     return (sortedData[static_cast<size_t>(index)] * ptc + sortedData[static_cast<size_t>(index) + 1] * (1.0 - ptc)) / 2.0;
 }
 
-double Calculate::Covariance(const std::vector<double>& data1, const std::vector<double>& data2) {
+double Calculate::Covariance(StridedView data1, StridedView data2) {
+    Tracer::Scope scope("Calculate::Covariance");
 
     double meanData1 = Calculate::Mean(data1);
     double meanData2 = Calculate::Mean(data2);
 
     // Calcul de la covariance
-    double covariance = 0.0;
+    CompensatedSum covariance;
     double count = 0;
-    for (size_t i = 0; i < data1.size(); ++i) {
+    for (size_t i = 0; i < data1.size; ++i) {
         if (!std::isnan(data1[i]) && !std::isnan(data2[i])) {
-            covariance += (data1[i] - meanData1) * (data2[i] - meanData2);
+            covariance.add((data1[i] - meanData1) * (data2[i] - meanData2));
             count++;
         }
     }
 
-    return covariance / count;
+    return covariance.value() / count;
 }
 
-double Calculate::PearsonCorrelation(const std::vector<double>& data1, const std::vector<double>& data2) {
+double Calculate::PearsonCorrelation(StridedView data1, StridedView data2) {
+    Tracer::Scope scope("Calculate::PearsonCorrelation");
     double covariance = Calculate::Covariance(data1, data2);
 
     double stdDevData1 = Calculate::StandardDeviation(data1);
@@ -142,24 +311,20 @@ double Calculate::LogisticRegressionHypothesis(const std::vector<double>& weight
 double Calculate::Accuracy(const std::vector<std::vector<double>>& inputs, const std::vector<std::vector<double>>& targets,
     const std::vector<std::vector<double>>& weights)
 {
+    Tracer::Scope scope("Calculate::Accuracy");
     const size_t dataSize = inputs.size();
     const size_t houseCount = weights.size();
+    const size_t featuresCount = houseCount ? weights[0].size() : 0;
     double correctPredictions = 0;
 
+    std::vector<size_t> predictedHouses(dataSize);
+    const std::vector<double> flatWeights = ScoringKernels::Flatten(weights);
+    ScoringKernels::Select(featuresCount, houseCount).predict(inputs, 0, dataSize, flatWeights.data(), featuresCount, houseCount,
+        predictedHouses.data());
+
     for (size_t i = 0; i < dataSize; ++i)
     {
-        double maxProbability = -1.0;
-        size_t predictedHouse = 0;
-
-        for (size_t house = 0; house < houseCount; ++house)
-        {
-            double probability = Calculate::LogisticRegressionHypothesis(weights[house], inputs[i]);
-            if (probability > maxProbability)
-            {
-                maxProbability = probability;
-                predictedHouse = house;
-            }
-        }
+        const size_t predictedHouse = predictedHouses[i];
         if (targets[i][predictedHouse] == 1.0)
         {
             correctPredictions++;
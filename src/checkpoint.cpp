@@ -0,0 +1,158 @@
+#include "checkpoint.h"
+#include "tracer.h"
+#include <charconv>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string_view>
+
+namespace {
+
+// Function to write a double in hexadecimal, which keeps every bit of it
+void writeDouble(std::ostream& file, double value) {
+    char buffer[32];
+    const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value, std::chars_format::hex);
+    file << " " << std::string_view(buffer, static_cast<size_t>(result.ptr - buffer));
+}
+
+// Function to read a double written by writeDouble
+bool readDouble(std::istream& file, double& value) {
+    std::string token;
+    if (!(file >> token)) {
+        return false;
+    }
+    const auto result = std::from_chars(token.data(), token.data() + token.size(), value, std::chars_format::hex);
+    return result.ec == std::errc() && result.ptr == token.data() + token.size();
+}
+
+// Function to read a line of doubles of a known length
+bool readDoubles(std::istream& file, std::vector<double>& values) {
+    for (auto& value : values) {
+        if (!readDouble(file, value)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+std::string Checkpoint::Path(const std::string& modelPath) {
+    return modelPath + ".checkpoint";
+}
+
+bool Checkpoint::Load(const std::string& path, TrainingCheckpoint& checkpoint) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    std::string line, key;
+    size_t featuresCount = 0, housesCount = 0;
+    bool valid = std::getline(file, line) && line == Magic;
+    valid = valid && (file >> key >> checkpoint.epoch >> key >> checkpoint.epochs >> key >> checkpoint.rows >> key >> featuresCount);
+    checkpoint.selectedFeatures.resize(featuresCount);
+    for (size_t i = 0; valid && i < featuresCount; ++i) {
+        valid = static_cast<bool>(file >> checkpoint.selectedFeatures[i]);
+    }
+
+    checkpoint.featureMeans.resize(featuresCount);
+    checkpoint.featureStdDevs.resize(featuresCount);
+    valid = valid && (file >> key) && readDoubles(file, checkpoint.featureMeans)
+        && (file >> key) && readDoubles(file, checkpoint.featureStdDevs) && (file >> key >> housesCount);
+    checkpoint.weights.assign(valid ? housesCount : 0, std::vector<double>(featuresCount));
+    for (auto& houseWeights : checkpoint.weights) {
+        valid = valid && readDoubles(file, houseWeights);
+    }
+
+    // The generator state is the rest of its line
+    valid = valid && (file >> key) && std::getline(file, checkpoint.generator);
+    if (!valid || checkpoint.epoch > checkpoint.epochs) {
+        throw std::runtime_error("Error: Invalid checkpoint file " + path);
+    }
+    return true;
+}
+
+void Checkpoint::Save(const std::string& path, const TrainingCheckpoint& checkpoint) {
+    // Written next to the checkpoint then renamed over it, so that a run killed while writing keeps the previous one.
+    const std::string temporaryPath = path + ".tmp";
+    std::ofstream file(temporaryPath);
+    if (!file.is_open()) {
+        throw std::runtime_error("Error: Unable to open the file " + temporaryPath + " for writing.");
+    }
+
+    file << Magic << "\n";
+    file << "Epoch: " << checkpoint.epoch << "\n";
+    file << "Epochs: " << checkpoint.epochs << "\n";
+    file << "Rows: " << checkpoint.rows << "\n";
+    file << "SelectedFeatures: " << checkpoint.selectedFeatures.size();
+    for (size_t feature : checkpoint.selectedFeatures) {
+        file << " " << feature;
+    }
+    file << "\nMeans:";
+    for (double mean : checkpoint.featureMeans) {
+        writeDouble(file, mean);
+    }
+    file << "\nStdDevs:";
+    for (double stdDev : checkpoint.featureStdDevs) {
+        writeDouble(file, stdDev);
+    }
+    file << "\nWeights: " << checkpoint.weights.size() << "\n";
+    for (const auto& houseWeights : checkpoint.weights) {
+        for (double weight : houseWeights) {
+            writeDouble(file, weight);
+        }
+        file << "\n";
+    }
+    file << "Generator: " << checkpoint.generator << "\n";
+    file.close();
+
+    if (!file || std::rename(temporaryPath.c_str(), path.c_str()) != 0) {
+        throw std::runtime_error("Error: Unable to write the file " + path);
+    }
+}
+
+Checkpoint::Writer::Writer(std::string path) : path(std::move(path)), thread(&Writer::run, this) {
+}
+
+Checkpoint::Writer::~Writer() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    ready.notify_one();
+    thread.join();
+}
+
+void Checkpoint::Writer::Submit(TrainingCheckpoint checkpoint) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        pending = std::move(checkpoint);
+    }
+    ready.notify_one();
+}
+
+void Checkpoint::Writer::run() {
+    Tracer::SetThreadName("checkpoint");
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        ready.wait(lock, [this] { return pending.has_value() || stopping; });
+        if (!pending) {
+            return;
+        }
+
+        TrainingCheckpoint checkpoint = std::move(*pending);
+        pending.reset();
+        lock.unlock();
+        // A failed checkpoint only loses the progress since the previous one, so the training goes on
+        try {
+            Tracer::Scope scope("checkpoint.write");
+            Save(path, checkpoint);
+        }
+        catch (const std::exception& e) {
+            std::cerr << "Warning: " << e.what() << std::endl;
+        }
+        lock.lock();
+    }
+}
@@ -0,0 +1,274 @@
+#include "column_stats.h"
+#include "utils.h"
+#include "profiler.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+
+// Bytes hashed at each end of the summarized range.
+const size_t ChecksumWindow = 4096;
+
+// Function to merge adjacent centroids until at most SketchSize remain, each holding about count / SketchSize values.
+void compress(ColumnSummary& summary) {
+    auto& centroids = summary.centroids;
+    std::sort(centroids.begin(), centroids.end());
+
+    const double maxWeight = std::max(1.0, std::ceil(static_cast<double>(summary.count) / static_cast<double>(ColumnStats::SketchSize)));
+    size_t kept = 0;
+    for (size_t i = 1; i < centroids.size(); ++i) {
+        auto& last = centroids[kept];
+        const auto& next = centroids[i];
+        if (last.second + next.second <= maxWeight) {
+            const double weight = last.second + next.second;
+            last.first += (next.first - last.first) * next.second / weight;
+            last.second = weight;
+        }
+        else {
+            centroids[++kept] = next;
+        }
+    }
+    centroids.resize(centroids.empty() ? 0 : kept + 1);
+}
+
+// Function to hash the first and last bytes of the range [0, offset) of a file with FNV-1a.
+uint64_t checksum(const std::string& filename, size_t offset) {
+    std::ifstream file(filename, std::ios::binary);
+    uint64_t hash = 14695981039346656037ull;
+    auto hashRange = [&](size_t begin, size_t end) {
+        std::string bytes(end - begin, '\0');
+        file.clear();
+        file.seekg(static_cast<std::streamoff>(begin));
+        file.read(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+        for (unsigned char byte : bytes) {
+            hash = (hash ^ byte) * 1099511628211ull;
+        }
+    };
+    hashRange(0, std::min(offset, ChecksumWindow));
+    hashRange(offset - std::min(offset, ChecksumWindow), offset);
+    return hash;
+}
+
+} // namespace
+
+void ColumnStats::Add(ColumnSummary& summary, double value) {
+    if (std::isnan(value)) {
+        return;
+    }
+
+    summary.count++;
+    summary.sum += value;
+    const double delta = value - summary.mean;
+    summary.mean += delta / static_cast<double>(summary.count);
+    summary.m2 += delta * (value - summary.mean);
+    summary.min = std::min(summary.min, value);
+    summary.max = std::max(summary.max, value);
+
+    summary.centroids.emplace_back(value, 1.0);
+    if (summary.centroids.size() >= 2 * SketchSize) {
+        compress(summary);
+    }
+}
+
+void ColumnStats::Merge(ColumnSummary& summary, const ColumnSummary& other) {
+    if (other.count == 0) {
+        return;
+    }
+    if (summary.count == 0) {
+        summary = other;
+        return;
+    }
+
+    const double count = static_cast<double>(summary.count);
+    const double otherCount = static_cast<double>(other.count);
+    const double total = count + otherCount;
+    const double delta = other.mean - summary.mean;
+    summary.mean += delta * otherCount / total;
+    summary.m2 += other.m2 + delta * delta * count * otherCount / total;
+    summary.count += other.count;
+    summary.sum += other.sum;
+    summary.min = std::min(summary.min, other.min);
+    summary.max = std::max(summary.max, other.max);
+
+    summary.centroids.insert(summary.centroids.end(), other.centroids.begin(), other.centroids.end());
+    compress(summary);
+}
+
+double ColumnStats::StandardDeviation(const ColumnSummary& summary) {
+    return std::sqrt(summary.m2 / static_cast<double>(summary.count));
+}
+
+double ColumnStats::Percentile(const ColumnSummary& summary, double percent) {
+    if (summary.count == 0) {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+
+    auto centroids = summary.centroids;
+    std::sort(centroids.begin(), centroids.end());
+
+    // Each centroid sits at the middle of the ranks it holds, so single values land on their exact rank.
+    const double rank = percent / 100.0 * static_cast<double>(summary.count - 1) + 0.5;
+    double before = 0.0;
+    double previousCenter = 0.0;
+    double previousMean = summary.min;
+    for (const auto& [mean, weight] : centroids) {
+        const double center = before + weight / 2.0;
+        if (rank <= center) {
+            if (center == previousCenter) {
+                return mean;
+            }
+            return previousMean + (mean - previousMean) * (rank - previousCenter) / (center - previousCenter);
+        }
+        before += weight;
+        previousCenter = center;
+        previousMean = mean;
+    }
+    return summary.max;
+}
+
+std::string ColumnStats::SidecarPath(const std::string& filename) {
+    return filename + ".stats";
+}
+
+DatasetSummary ColumnStats::UpdateFile(const std::string& filename) {
+    const std::string sidecarPath = SidecarPath(filename);
+    DatasetSummary dataset;
+    if (!Load(sidecarPath, dataset) || dataset.offset > static_cast<size_t>(std::filesystem::file_size(filename))
+        || checksum(filename, dataset.offset) != dataset.checksum) {
+        dataset = DatasetSummary();
+    }
+
+    // Only the appended lines are parsed, the columns of the previous ones are already summarized.
+    std::vector<StudentInfo> students;
+    std::vector<std::string> headers;
+    size_t featuresStartIndex = dataset.featuresStartIndex;
+    const size_t end = Utils::LoadDataTail(filename, dataset.offset, headers, featuresStartIndex, students);
+    if (!dataset.headers.empty() && headers != dataset.headers) {
+        throw std::runtime_error("Error: The header of " + filename + " changed since " + sidecarPath + " was written.");
+    }
+
+    Profiler::Phase phase("stats.merge", students.size());
+    std::vector<ColumnSummary> appended(headers.size() - featuresStartIndex);
+    for (const auto& student : students) {
+        for (size_t i = 0; i < appended.size(); ++i) {
+            Add(appended[i], student.features[i]);
+        }
+    }
+
+    dataset.columns.resize(appended.size());
+    for (size_t i = 0; i < appended.size(); ++i) {
+        Merge(dataset.columns[i], appended[i]);
+    }
+    dataset.headers = headers;
+    dataset.featuresStartIndex = featuresStartIndex;
+    dataset.rows += students.size();
+    dataset.offset = end;
+    dataset.checksum = checksum(filename, end);
+    phase.Stop();
+
+    Save(sidecarPath, dataset);
+    return dataset;
+}
+
+DatasetSummary ColumnStats::Update(const std::string& filenames) {
+    const std::vector<std::string> files = Utils::ExpandDataFiles(filenames);
+    std::vector<DatasetSummary> shards(files.size());
+    Utils::ParallelFor(files.size(), [&](size_t i) {
+        shards[i] = UpdateFile(files[i]);
+    });
+    if (shards.size() == 1) {
+        return shards[0];
+    }
+
+    Profiler::Phase phase("stats.merge");
+    DatasetSummary dataset;
+    dataset.headers = shards[0].headers;
+    dataset.featuresStartIndex = shards[0].featuresStartIndex;
+    dataset.columns.resize(shards[0].columns.size());
+    for (size_t i = 0; i < shards.size(); ++i) {
+        if (shards[i].headers != dataset.headers || shards[i].featuresStartIndex != dataset.featuresStartIndex) {
+            throw std::runtime_error("Error: The columns of " + files[i] + " differ from the ones of " + files[0]);
+        }
+        for (size_t column = 0; column < dataset.columns.size(); ++column) {
+            Merge(dataset.columns[column], shards[i].columns[column]);
+        }
+        dataset.rows += shards[i].rows;
+    }
+    return dataset;
+}
+
+bool ColumnStats::Load(const std::string& path, DatasetSummary& dataset) {
+    std::ifstream file(path);
+    std::string line;
+    if (!file.is_open() || !std::getline(file, line) || line != Magic) {
+        return false;
+    }
+
+    std::string key, headers;
+    size_t columnsCount = 0;
+    file >> key >> dataset.offset >> key >> dataset.checksum >> key >> dataset.rows
+        >> key >> dataset.featuresStartIndex >> key >> columnsCount >> key;
+    file.ignore(1);
+    std::getline(file, headers);
+    std::istringstream headersStream(headers);
+    for (std::string header; std::getline(headersStream, header, ',');) {
+        dataset.headers.push_back(header);
+    }
+
+    dataset.columns.resize(columnsCount);
+    for (auto& column : dataset.columns) {
+        size_t centroidsCount = 0;
+        file >> column.count >> column.sum >> column.mean >> column.m2 >> column.min >> column.max >> centroidsCount;
+        if (column.count == 0) {
+            column = ColumnSummary();
+        }
+        column.centroids.resize(centroidsCount);
+        for (auto& [mean, weight] : column.centroids) {
+            file >> mean >> weight;
+        }
+    }
+
+    return static_cast<bool>(file) && dataset.featuresStartIndex + columnsCount == dataset.headers.size();
+}
+
+void ColumnStats::Save(const std::string& path, const DatasetSummary& dataset) {
+    // Written next to the sidecar then renamed over it, so that an interrupted run leaves the previous one intact.
+    const std::string temporaryPath = path + ".tmp";
+    std::ofstream file(temporaryPath);
+    if (!file.is_open()) {
+        throw std::runtime_error("Error: Unable to open the file " + temporaryPath + " for writing.");
+    }
+
+    file << std::setprecision(17);
+    file << Magic << "\n";
+    file << "Offset: " << dataset.offset << "\n";
+    file << "Checksum: " << dataset.checksum << "\n";
+    file << "Rows: " << dataset.rows << "\n";
+    file << "FeaturesStartIndex: " << dataset.featuresStartIndex << "\n";
+    file << "Columns: " << dataset.columns.size() << "\n";
+    file << "Headers:";
+    for (size_t i = 0; i < dataset.headers.size(); ++i) {
+        file << (i ? "," : " ") << dataset.headers[i];
+    }
+    file << "\n";
+
+    for (const auto& column : dataset.columns) {
+        // The extrema of an empty column are infinite, which streams cannot read back.
+        file << column.count << " " << column.sum << " " << column.mean << " " << column.m2 << " "
+            << (column.count ? column.min : 0.0) << " " << (column.count ? column.max : 0.0) << " " << column.centroids.size();
+        for (const auto& [mean, weight] : column.centroids) {
+            file << " " << mean << " " << weight;
+        }
+        file << "\n";
+    }
+    file.close();
+
+    if (!file || std::rename(temporaryPath.c_str(), path.c_str()) != 0) {
+        throw std::runtime_error("Error: Unable to write the file " + path);
+    }
+}
@@ -0,0 +1,61 @@
+#include "commands.h"
+#include "calculate.h"
+#include "feature_column.h"
+#include "profiler.h"
+
+namespace {
+
+// Function to print the statistics of feature columns
+void describeColumns(const std::vector<FeatureColumn>& featuresValues, std::ostream& out)
+{
+    Profiler::Phase phase("statistics");
+    Utils::printFeatureHeader(featuresValues.size(), out);
+    Utils::computeAndPrintFeatures("Count", [](const FeatureColumn& column) { return Calculate::Count(column); }, featuresValues, out);
+    Utils::computeAndPrintFeatures("Mean", [](const FeatureColumn& column) { return Calculate::Mean(column); }, featuresValues, out);
+    Utils::computeAndPrintFeatures("Std", [](const FeatureColumn& column) { return Calculate::StandardDeviation(column); }, featuresValues, out);
+    Utils::computeAndPrintFeatures("Min", [](const FeatureColumn& column) { return Calculate::Min(column); }, featuresValues, out);
+    Utils::computeAndPrintFeatures("25%", [](const FeatureColumn& column) { return Calculate::Quartile(column, 25); }, featuresValues, out);
+    Utils::computeAndPrintFeatures("50%", [](const FeatureColumn& column) { return Calculate::Quartile(column, 50); }, featuresValues, out);
+    Utils::computeAndPrintFeatures("75%", [](const FeatureColumn& column) { return Calculate::Quartile(column, 75); }, featuresValues, out);
+    Utils::computeAndPrintFeatures("Max", [](const FeatureColumn& column) { return Calculate::Max(column); }, featuresValues, out);
+}
+
+} // namespace
+
+// Function to print the statistics of every feature
+void Commands::Describe(const Dataset& dataset, std::ostream& out)
+{
+    // Missing values are marked in the validity bitmaps, so they are not counted
+    describeColumns(FeatureColumn::FromStudents(dataset.students), out);
+}
+
+// Function to print the statistics of every compressed feature
+void Commands::Describe(const CompactDataset& dataset, std::ostream& out)
+{
+    describeColumns(dataset.features, out);
+}
+
+// Function to print the statistics of every feature from its column summary
+void Commands::DescribeSummary(const DatasetSummary& summary, std::ostream& out)
+{
+    const int fieldWidth = 14;
+    auto printRow = [&](const std::string& sectionName, auto function) {
+        out << std::setw(fieldWidth) << std::left << sectionName;
+        for (const auto& column : summary.columns)
+        {
+            out << std::setw(fieldWidth) << std::right << std::fixed << std::setprecision(6) << function(column);
+        }
+        out << std::endl;
+    };
+
+    Profiler::Phase phase("statistics");
+    Utils::printFeatureHeader(summary.columns.size(), out);
+    printRow("Count", [](const ColumnSummary& column) { return static_cast<double>(column.count); });
+    printRow("Mean", [](const ColumnSummary& column) { return column.mean; });
+    printRow("Std", ColumnStats::StandardDeviation);
+    printRow("Min", [](const ColumnSummary& column) { return column.min; });
+    printRow("25%", [](const ColumnSummary& column) { return ColumnStats::Percentile(column, 25); });
+    printRow("50%", [](const ColumnSummary& column) { return ColumnStats::Percentile(column, 50); });
+    printRow("75%", [](const ColumnSummary& column) { return ColumnStats::Percentile(column, 75); });
+    printRow("Max", [](const ColumnSummary& column) { return column.max; });
+}
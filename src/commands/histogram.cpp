@@ -0,0 +1,208 @@
+#include "commands.h"
+#include "calculate.h"
+#include "binning.h"
+#include "profiler.h"
+
+// Function definition for generating histogram
+void Commands::Histogram(const Dataset& dataset, size_t bins, std::ostream& out)
+{
+    const std::vector<StudentInfo>& students = dataset.students;
+    const std::vector<std::string>& headers = dataset.headers;
+    const size_t featuresCount = students[0].features.size();
+
+    // Constants for indices
+    const size_t labelsCount = headers.size() - featuresCount - 1;
+    const size_t labelsStartIndex = 1;
+    const size_t featuresStartIndex = labelsCount + 1;
+
+    // Extract feature names and labels
+    std::vector<std::string> features;
+    for (size_t i = featuresStartIndex; i < headers.size(); i++)
+    {
+        features.push_back(headers[i]);
+    }
+
+    std::vector<std::string> labels;
+    for (size_t i = labelsStartIndex; i < featuresStartIndex; i++)
+    {
+        labels.push_back(headers[i]);
+    }
+
+    // Find the index of the "Hogwarts House" label
+    size_t houseIndex = 0;
+    for (size_t i = labelsStartIndex; i < featuresStartIndex; i++)
+    {
+        if (headers[i] == "Hogwarts House")
+        {
+            houseIndex = i - 1;
+            break;
+        }
+    }
+
+    // Number of Hogwarts houses
+    const size_t housesCount = 4;
+
+    // View the feature values by house in one store grouped by house, without a copy per house
+    const GroupedColumns groupedColumns = Utils::GroupFeatures(students, houseIndex, { "Ravenclaw", "Slytherin", "Gryffindor", "Hufflepuff" });
+    const std::vector<std::vector<std::span<const double>>> featuresValuesByHouse = groupedColumns.views();
+
+    // Display the header
+    Profiler::Phase statisticsPhase("statistics");
+    Utils::printFeatureHeader(featuresCount, out);
+
+    // Calculate and display the standard deviation for each house
+    auto standardDeviation = [](StridedView data) { return Calculate::StandardDeviation(data); };
+    Utils::computeAndPrintFeatures("Ravenclaw Std", standardDeviation, featuresValuesByHouse[0], out);
+    Utils::computeAndPrintFeatures("Slytherin Std", standardDeviation, featuresValuesByHouse[1], out);
+    Utils::computeAndPrintFeatures("Gryffindor Std", standardDeviation, featuresValuesByHouse[2], out);
+    Utils::computeAndPrintFeatures("Hufflepuff Std", standardDeviation, featuresValuesByHouse[3], out);
+
+    // Initialize vectors to store heterogeneity and standard deviation of features
+    std::vector<double> heterogeneities;
+    std::vector<std::vector<double>> featuresStd;
+
+    // Calculate the standard deviation of the standard deviation (heterogeneity) for the current feature
+    for (size_t i = 0; i < featuresCount; i++)
+    {
+        std::vector<double> featureStd;
+        for (size_t j = 0; j < housesCount; j++)
+        {
+            featureStd.push_back(Calculate::StandardDeviation(featuresValuesByHouse[j][i]));
+        }
+        heterogeneities.push_back(Calculate::StandardDeviation(featureStd));
+        featuresStd.push_back(featureStd);
+    }
+
+    // Calculate and display the heterogeneity of features
+    Utils::computeAndPrintFeatures("Heterogeneity", standardDeviation, featuresStd, out);
+    out << std::endl;
+    out << "Which Hogwarts course has a homogeneous score distribution between all four houses ?" << std::endl;
+
+    double HighestHomogeneity = std::numeric_limits<double>::max();
+    size_t featureIndex = 0;
+
+    // Find the feature with the highest homogeneity (lowest heterogeneity) value
+    for (size_t i = 0; i < featuresCount; i++)
+    {
+        double heterogeneity = Calculate::StandardDeviation(featuresStd[i]);
+        if (heterogeneity < HighestHomogeneity)
+        {
+            HighestHomogeneity = heterogeneity;
+            featureIndex = i;
+        }
+    }
+
+    // Display the feature with the highest homogeneity
+    out << "The highest homogeneity (lowest heterogeneity) value is " << HighestHomogeneity << " in the course (feature) " << featureIndex + 1 << " : " << headers[featuresStartIndex + featureIndex] << std::endl;
+
+    statisticsPhase.Stop();
+
+    // Bin the scores of every course by house, so that the plot only receives the bin counts
+    Profiler::Phase binningPhase("binning");
+    std::vector<std::vector<Histogram1D>> histograms = Binning::HistogramsByGroup(featuresValuesByHouse, bins);
+    binningPhase.Stop();
+
+    // Create a Python script to generate the histogram
+    std::string pythonScript = "histogram.py";
+    std::ofstream pythonFile(pythonScript);
+    if (pythonFile.is_open())
+    {
+        // Write the Python script
+        pythonFile << "import matplotlib.pyplot as plt\n\n";
+        pythonFile << "heterogeneities = [" + std::to_string(heterogeneities[0]);
+        for (size_t i = 1; i < heterogeneities.size(); ++i)
+        {
+            pythonFile << ", " + std::to_string(heterogeneities[i]);
+        }
+        pythonFile << "]\n";
+
+        pythonFile << "features = ['" + features[0] + "'";
+        for (size_t i = 1; i < features.size(); ++i)
+        {
+            pythonFile << ", '" + features[i] + "'";
+        }
+        pythonFile << "]\n";
+
+        // Configure and display the histogram in Matplotlib
+        pythonFile << "plt.figure()\n";
+        pythonFile << "plt.bar(features, heterogeneities)\n";
+        pythonFile << "plt.xlabel('Subjects', fontsize=12)\n";
+        pythonFile << "plt.ylabel('Heterogeneity (logarithmic scale)', fontsize=12)\n";
+        pythonFile << "plt.title('Heterogeneity by Subject', fontsize=14)\n";
+        pythonFile << "plt.xticks(features, rotation=45, ha='right', fontsize=6)\n";
+        pythonFile << "plt.yscale('log')\n";
+        pythonFile << "plt.subplots_adjust(bottom=0.29)\n";
+
+        // Write the bin ranges and the bin counts of every course, indexed [course][house]
+        pythonFile << "houses = ['Ravenclaw', 'Slytherin', 'Gryffindor', 'Hufflepuff']\n";
+        pythonFile << "ranges = [";
+        for (size_t i = 0; i < histograms.size(); ++i)
+        {
+            pythonFile << (i ? ", " : "") << "(" << histograms[i][0].min << ", " << histograms[i][0].max << ")";
+        }
+        pythonFile << "]\n";
+
+        pythonFile << "counts = [";
+        for (size_t i = 0; i < histograms.size(); ++i)
+        {
+            pythonFile << (i ? ", " : "") << "[";
+            for (size_t j = 0; j < housesCount; ++j)
+            {
+                pythonFile << (j ? ", " : "") << "[";
+                for (size_t k = 0; k < histograms[i][j].counts.size(); ++k)
+                {
+                    pythonFile << (k ? ", " : "") << histograms[i][j].counts[k];
+                }
+                pythonFile << "]";
+            }
+            pythonFile << "]";
+        }
+        pythonFile << "]\n";
+
+        // Configure the histograms of every course by house
+        pythonFile << "columns = 4\n";
+        pythonFile << "fig, axs = plt.subplots(ncols=columns, nrows=(len(features) + columns - 1) // columns, figsize=(12, 8))\n";
+        pythonFile << "fig.suptitle('Score distribution by house', fontsize=14)\n";
+        pythonFile << "for i, ax in enumerate(axs.flat):\n";
+        pythonFile << "    if i >= len(features):\n";
+        pythonFile << "        ax.axis('off')\n";
+        pythonFile << "        continue\n";
+        pythonFile << "    low, high = ranges[i]\n";
+        pythonFile << "    n = len(counts[i][0])\n";
+        pythonFile << "    edges = [low + (high - low) * k / n for k in range(n + 1)]\n";
+        pythonFile << "    for h, house in enumerate(houses):\n";
+        pythonFile << "        ax.stairs(counts[i][h], edges, label=house, fill=True, alpha=0.4)\n";
+        pythonFile << "    ax.set_title(features[i], fontsize=8)\n";
+        pythonFile << "    ax.tick_params(labelsize=6)\n";
+        pythonFile << "axs.flat[0].legend(fontsize=6)\n";
+        pythonFile << "plt.tight_layout()\n";
+        pythonFile << "plt.show()\n";
+
+        pythonFile.close();
+    }
+    else
+    {
+        // Handle file writing error
+        std::cerr << "Error writing Python file." << std::endl;
+        return;
+    }
+
+#ifndef _MSC_VER
+
+    // Execute the Python script using Python3
+    Utils::executeCommand("python " + pythonScript);
+
+#else
+
+    // Execute the Python script using Python
+    Utils::executeCommand("python " + pythonScript);
+
+#endif // MVS
+
+    // Remove the temporary Python script file
+    if (std::remove(pythonScript.c_str()) != 0)
+    {
+        std::cerr << "Error deleting temporary Python file." << std::endl;
+        return;
+    }
+}
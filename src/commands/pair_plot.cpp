@@ -0,0 +1,164 @@
+#include "commands.h"
+#include "calculate.h"
+#include "binning.h"
+#include "profiler.h"
+
+// Function definition for generating scatter plot matrix
+void Commands::PairPlot(const Dataset& dataset, size_t bins, std::ostream&)
+{
+    const std::vector<StudentInfo>& studentData = dataset.students;
+    const size_t featuresCount = studentData[0].features.size();
+
+    // Python script file name, distinct from the scatter plot one so that both can run at once
+    std::string pythonScript = "pairplot.py";
+
+    // Open Python script file
+    std::ofstream pythonFile(pythonScript);
+    if (pythonFile.is_open())
+    {
+        // Write Python script header
+        pythonFile << "import numpy as np\n";
+        pythonFile << "import matplotlib.pyplot as plt\n\n";
+
+        // Define house indices and colors
+        std::unordered_map<size_t, std::string> housesIndex;
+        housesIndex[0] = "Slytherin";
+        housesIndex[1] = "Ravenclaw";
+        housesIndex[2] = "Gryffindor";
+        housesIndex[3] = "Hufflepuff";
+        std::vector<std::string> houseColors = { "green", "blue", "red", "gold" };
+        const size_t housesCount = 4;
+
+        // Split the features values by house, as ranges of one store grouped by house
+        std::vector<std::string> houses;
+        for (size_t h = 0; h < housesCount; ++h)
+        {
+            houses.push_back(housesIndex[h]);
+        }
+        const GroupedColumns groupedColumns = Utils::GroupFeatures(studentData, 0, houses);
+        const std::vector<std::vector<std::span<const double>>> featuresValuesByHouse = groupedColumns.views();
+
+        // Bin the features values, so that the plot size only depends on the number of bins
+        Profiler::Phase binningPhase("binning");
+        std::vector<std::vector<Histogram1D>> histograms = Binning::HistogramsByGroup(featuresValuesByHouse, bins);
+        std::vector<std::vector<Histogram2D>> grids = Binning::DensityGridsByGroup(featuresValuesByHouse, bins);
+        binningPhase.Stop();
+
+        // Write the histograms of every feature, indexed [feature][house]
+        pythonFile << "ranges = [";
+        for (size_t i = 0; i < featuresCount; ++i)
+        {
+            pythonFile << (i ? ", " : "") << "(" << histograms[i][0].min << ", " << histograms[i][0].max << ")";
+        }
+        pythonFile << "]\n";
+        pythonFile << "histograms = [";
+        for (size_t i = 0; i < featuresCount; ++i)
+        {
+            pythonFile << (i ? ", " : "") << "[";
+            for (size_t h = 0; h < housesCount; ++h)
+            {
+                pythonFile << (h ? ", " : "") << "[";
+                for (size_t k = 0; k < histograms[i][h].counts.size(); ++k)
+                {
+                    pythonFile << (k ? ", " : "") << histograms[i][h].counts[k];
+                }
+                pythonFile << "]";
+            }
+            pythonFile << "]";
+        }
+        pythonFile << "]\n";
+
+        // Write the density grids of every feature pair (i < j), indexed [pair][house]
+        pythonFile << "grids = [";
+        for (size_t p = 0; p < grids.size(); ++p)
+        {
+            pythonFile << (p ? ", " : "") << "[";
+            for (size_t h = 0; h < housesCount; ++h)
+            {
+                pythonFile << (h ? ", " : "") << "np.array([";
+                for (size_t k = 0; k < grids[p][h].counts.size(); ++k)
+                {
+                    pythonFile << (k ? ", " : "") << grids[p][h].counts[k];
+                }
+                pythonFile << "]).reshape(" << grids[p][h].yBins << ", " << grids[p][h].xBins << ")";
+            }
+            pythonFile << "]";
+        }
+        pythonFile << "]\n";
+
+        pythonFile << "colors = [";
+        for (size_t h = 0; h < housesCount; ++h)
+        {
+            pythonFile << (h ? ", " : "") << "'" << houseColors[h] << "'";
+        }
+        pythonFile << "]\n";
+        pythonFile << "count = " << featuresCount << "\n";
+        pythonFile << "def pair(i, j):\n";
+        pythonFile << "    return i * count - i * (i + 1) // 2 + (j - i - 1)\n\n";
+
+        // Set up parameters for the scatter plot matrix
+        const double subplotsSizeX = 1;
+        const double subplotsSizeY = 0.5;
+        const double lineWidth = 0.3;
+        const std::string graphTitle = "Scatter Plot Matrix";
+
+        // Write code for creating scatter plot matrix
+        pythonFile << "fig, axs = plt.subplots(ncols=" << featuresCount << ", nrows=" << featuresCount << ", figsize=(" << subplotsSizeX * (double)(featuresCount) << ", " << subplotsSizeY * (double)(featuresCount) << "))\n";
+        pythonFile << "fig.suptitle('" << graphTitle << "')\n";
+        pythonFile << "plt.subplots_adjust(top=0.9, bottom=0.05, left=0.1, right=0.95, hspace=0.05, wspace=0.05)\n";
+
+        // Add labels to the plots
+        for (size_t feature1 = 0; feature1 < featuresCount; ++feature1)
+        {
+            pythonFile << "axs[" << feature1 << ", 0].text(0.0, 0.5, 'F " << (feature1 + 1) << "', transform=axs[" << feature1 << ", 0].transAxes, rotation=0, va='center', ha='right')\n";
+        }
+
+        for (size_t feature2 = 0; feature2 < featuresCount; ++feature2)
+        {
+            pythonFile << "axs[0, " << feature2 << "].text(0.5, 1.0, 'F " << (feature2 + 1) << "', transform=axs[0, " << feature2 << "].transAxes, va='bottom', ha='center')\n";
+        }
+
+        // Plot the histograms on the diagonal and the density contours of each house elsewhere
+        pythonFile << "for f1 in range(count):\n";
+        pythonFile << "    for f2 in range(count):\n";
+        pythonFile << "        ax = axs[f1, f2]\n";
+        pythonFile << "        for h in range(" << housesCount << "):\n";
+        pythonFile << "            if f1 == f2:\n";
+        pythonFile << "                low, high = ranges[f1]\n";
+        pythonFile << "                n = len(histograms[f1][h])\n";
+        pythonFile << "                ax.stairs(histograms[f1][h], np.linspace(low, high, n + 1), color=colors[h], fill=True, alpha=0.4)\n";
+        pythonFile << "                continue\n";
+        pythonFile << "            grid = grids[pair(min(f1, f2), max(f1, f2))][h]\n";
+        pythonFile << "            if grid.max() == 0:\n";
+        pythonFile << "                continue\n";
+        pythonFile << "            ax.contour(grid if f1 < f2 else grid.T, levels=3, colors=colors[h], linewidths=" << lineWidth << ")\n";
+
+        // Remove ticks and labels
+        pythonFile << "for ax in axs.flat:\n";
+        pythonFile << "    ax.tick_params(axis='both', which='both', bottom=False, top=False, left=False, right=False, labelbottom=False, labelleft=False)\n";
+
+        // Display the plot
+        pythonFile << "plt.show()\n";
+        pythonFile.close();
+    }
+    else
+    {
+        // Handle file writing error
+        std::cerr << "Error writing Python file." << std::endl;
+        return;
+    }
+
+    // Execute Python script based on the platform
+#ifndef _MSC_VER
+    Utils::executeCommand("python " + pythonScript);
+#else
+    Utils::executeCommand("python " + pythonScript);
+#endif
+
+    // Remove the temporary Python script file
+    if (std::remove(pythonScript.c_str()) != 0)
+    {
+        std::cerr << "Error deleting the temporary Python file." << std::endl;
+        return;
+    }
+}
@@ -0,0 +1,206 @@
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+#include "commands.h"
+#include "logreg.h"
+#include "profiler.h"
+#include "scoring_kernels.h"
+#include "output_writer.h"
+
+namespace {
+
+// Saved models with the kernels scoring them.
+struct LoadedModel {
+    std::string path;
+    std::vector<std::vector<double>> weights;
+    std::vector<double> featureMeans;
+    std::vector<double> featureStdDevs;
+    std::vector<size_t> selectedFeatures;
+    std::vector<double> flatWeights;
+    const ScoringKernels::Set* kernels = nullptr;
+};
+
+// Function to check that a loaded model has one weight line per house and one weight and normalization parameter
+// per selected feature, since the scoring indexes them without bounds checks
+void checkModel(const std::vector<std::vector<double>>& weights, const std::vector<double>& featureMeans,
+    const std::vector<double>& featureStdDevs, const std::vector<size_t>& selectedFeatures, const std::string& path)
+{
+    const size_t featuresCount = selectedFeatures.size();
+    if (weights.size() != LogisticRegression::HousesIndex.size() || featureMeans.size() != featuresCount
+        || featureStdDevs.size() != featuresCount
+        || std::any_of(weights.begin(), weights.end(), [&](const std::vector<double>& w) { return w.size() != featuresCount; }))
+    {
+        throw std::runtime_error("Error: Wrong model file " + path);
+    }
+}
+
+} // namespace
+
+// Function to predict the house of every student with the saved models
+void Commands::Predict(const Dataset& dataset, const std::string& modelPath, const std::string& outputPath, std::ostream&)
+{
+    // Load the models with the features they use
+    std::vector<std::vector<double>> weights;
+    std::vector<double> featureMeans, featureStdDevs;
+    std::vector<size_t> selectedFeatures;
+    Profiler::Phase modelPhase("load.model");
+    Utils::LoadWeightsAndNormalizationParameters(weights, featureMeans, featureStdDevs, selectedFeatures, modelPath);
+    checkModel(weights, featureMeans, featureStdDevs, selectedFeatures, modelPath);
+
+    modelPhase.Stop();
+
+    // Work on a copy of the selected features, since the students are imputed and normalized in place
+    std::vector<StudentInfo> students = Utils::SelectFeatures(dataset, LogisticRegression::TrainingProjection(selectedFeatures, false).features, false);
+
+    // Handle missing values with the training means of the model, as the compiled scorers and the C API do
+    LogisticRegression::HandleMissingValues(students, featureMeans);
+
+    // Normalize data
+    Utils::NormalizeData(students, featureMeans, featureStdDevs);
+
+    // Create input vectors
+    std::vector<size_t> inputFeatures(selectedFeatures.size());
+    std::iota(inputFeatures.begin(), inputFeatures.end(), 1);
+    std::vector<std::vector<double>> inputs;
+    LogisticRegression::CreateInputVectors(students, inputFeatures, inputs);
+
+    // Perform predictions and write results
+    LogisticRegression::PerformPredictions(students, weights, dataset.headers, inputs, outputPath);
+}
+
+// Function to predict the house of every student with several models, parsing and gathering the students only once
+void Commands::PredictModels(const Dataset& dataset, const std::vector<std::string>& modelPaths, const std::string& outputPath, std::ostream& out)
+{
+    Profiler::Phase modelPhase("load.model");
+    std::vector<LoadedModel> models(modelPaths.size());
+    std::vector<size_t> features;
+    for (size_t m = 0; m < models.size(); ++m)
+    {
+        LoadedModel& model = models[m];
+        model.path = modelPaths[m];
+        Utils::LoadWeightsAndNormalizationParameters(model.weights, model.featureMeans, model.featureStdDevs, model.selectedFeatures, model.path);
+        checkModel(model.weights, model.featureMeans, model.featureStdDevs, model.selectedFeatures, model.path);
+        model.flatWeights = ScoringKernels::Flatten(model.weights);
+        model.kernels = &ScoringKernels::Select(model.selectedFeatures.size(), model.weights.size());
+        features.insert(features.end(), model.selectedFeatures.begin(), model.selectedFeatures.end());
+    }
+    std::sort(features.begin(), features.end());
+    features.erase(std::unique(features.begin(), features.end()), features.end());
+    modelPhase.Stop();
+
+    // One column per feature used by any model. Missing values stay NaN, each model imputes them with its own means
+    Profiler::Phase gatherPhase("gather", dataset.students.size());
+    const size_t rows = dataset.students.size();
+    std::vector<std::vector<double>> columns(features.size(), std::vector<double>(rows));
+    for (size_t f = 0; f < features.size(); ++f)
+    {
+        auto it = std::find(dataset.featureColumns.begin(), dataset.featureColumns.end(), features[f] - 1);
+        if (it == dataset.featureColumns.end())
+        {
+            throw std::runtime_error("Error: Feature " + std::to_string(features[f]) + " was not loaded.");
+        }
+        const size_t position = static_cast<size_t>(it - dataset.featureColumns.begin());
+        for (size_t i = 0; i < rows; ++i)
+        {
+            columns[f][i] = dataset.students[i].features[position];
+        }
+    }
+    gatherPhase.Stop();
+
+    // Each model normalizes the shared columns into a reused batch of rows and scores it with its own kernels
+    std::vector<std::vector<size_t>> predictions(models.size(), std::vector<size_t>(rows));
+    const size_t batchSize = 4096;
+    for (size_t m = 0; m < models.size(); ++m)
+    {
+        Profiler::Phase phase("score", rows);
+        const LoadedModel& model = models[m];
+        const size_t featuresCount = model.selectedFeatures.size();
+        std::vector<const std::vector<double>*> modelColumns;
+        for (size_t feature : model.selectedFeatures)
+        {
+            modelColumns.push_back(&columns[std::lower_bound(features.begin(), features.end(), feature) - features.begin()]);
+        }
+
+        std::vector<std::vector<double>> batch(std::min(rows, batchSize), std::vector<double>(featuresCount));
+        for (size_t batchStart = 0; batchStart < rows; batchStart += batchSize)
+        {
+            Tracer::Scope scope("score.batch");
+            const size_t batchEnd = std::min(rows, batchStart + batchSize);
+            for (size_t i = batchStart; i < batchEnd; ++i)
+            {
+                for (size_t j = 0; j < featuresCount; ++j)
+                {
+                    const double value = std::isnan((*modelColumns[j])[i]) ? model.featureMeans[j] : (*modelColumns[j])[i];
+                    // Same operations as HandleMissingValues and Utils::NormalizeData, so that the predictions match the ones of Predict
+                    batch[i - batchStart][j] = model.featureStdDevs[j] != 0.0 ? (value - model.featureMeans[j]) / model.featureStdDevs[j] : value;
+                }
+            }
+            model.kernels->predict(batch, 0, batchEnd - batchStart, model.flatWeights.data(), featuresCount, model.weights.size(),
+                &predictions[m][batchStart]);
+        }
+        Profiler::AddCounter("rows_scored", static_cast<double>(rows));
+    }
+
+    // One prediction column per model
+    Profiler::Phase outputPhase("output");
+    OutputWriter output(outputPath);
+    output.Append(dataset.headers[0]);
+    for (const auto& model : models)
+    {
+        output.Append(',');
+        output.Append(dataset.headers[1] + " (" + model.path + ")");
+    }
+    output.Append('\n');
+    std::vector<std::string_view> houseNames(LogisticRegression::HousesIndex.size());
+    for (const auto& [house, name] : LogisticRegression::HousesIndex)
+    {
+        houseNames[house] = name;
+    }
+    for (size_t i = 0; i < rows; ++i)
+    {
+        output.Append(dataset.students[i].index);
+        for (const auto& modelPredictions : predictions)
+        {
+            output.Append(',');
+            output.Append(houseNames[modelPredictions[i]]);
+        }
+        output.Append('\n');
+    }
+    output.Close();
+    outputPhase.Stop();
+
+    // Disagreement summary: students on which any two models differ, then every pair of models
+    size_t disagreements = 0;
+    for (size_t i = 0; i < rows; ++i)
+    {
+        for (size_t m = 1; m < models.size(); ++m)
+        {
+            if (predictions[m][i] != predictions[0][i])
+            {
+                disagreements++;
+                break;
+            }
+        }
+    }
+    auto percent = [&](size_t count) {
+        return 100.0 * static_cast<double>(count) / static_cast<double>(rows);
+    };
+    out << std::fixed << std::setprecision(2);
+    out << "Models disagree on " << disagreements << " of " << rows << " students (" << percent(disagreements) << "%)" << std::endl;
+    for (size_t a = 0; a < models.size(); ++a)
+    {
+        for (size_t b = a + 1; b < models.size(); ++b)
+        {
+            size_t count = 0;
+            for (size_t i = 0; i < rows; ++i)
+            {
+                count += predictions[a][i] != predictions[b][i];
+            }
+            out << "  " << models[a].path << " vs " << models[b].path << ": " << count << " (" << percent(count) << "%)" << std::endl;
+        }
+    }
+}
@@ -0,0 +1,344 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+#include "commands.h"
+#include "logreg.h"
+#include "profiler.h"
+#include "column_stats.h"
+#include "checkpoint.h"
+#include "cross_validation.h"
+
+namespace {
+
+// Epochs of a training from scratch.
+const size_t TrainingEpochs = 100;
+
+// Function to train the one-vs-all models on a copy of the selected features of the students and save them,
+// checkpointing the training along the way and resuming it from its checkpoint as requested
+void trainSelected(std::vector<StudentInfo> students, const std::vector<size_t>& selectedFeatures, const std::string& modelPath,
+    std::ostream& out, const CheckpointOptions& options)
+{
+    // Handle missing values
+    LogisticRegression::HandleMissingValues(students);
+
+    // Normalize training data
+    std::vector<double> featureMeans, featureStdDevs;
+    Utils::NormalizeData(students, featureMeans, featureStdDevs);
+
+    // Set up data for training, over the copied features
+    std::vector<size_t> inputFeatures(selectedFeatures.size());
+    std::iota(inputFeatures.begin(), inputFeatures.end(), 1);
+    const std::unordered_map<size_t, std::string>& houseIndex = LogisticRegression::HousesIndex;
+
+    // The state of the run, continued from the checkpoint when there is one, else drawn from a new generator
+    const std::string checkpointPath = Checkpoint::Path(modelPath);
+    TrainingCheckpoint state;
+    std::mt19937 generator;
+    if (options.resume && Checkpoint::Load(checkpointPath, state))
+    {
+        // Weights only continue over the same normalized inputs, which the same rows give back exactly
+        if (state.rows != students.size() || state.selectedFeatures != selectedFeatures
+            || state.featureMeans != featureMeans || state.featureStdDevs != featureStdDevs
+            || state.weights.size() != houseIndex.size())
+        {
+            throw std::runtime_error("Error: The checkpoint " + checkpointPath + " was written by a training on other data.");
+        }
+        std::istringstream(state.generator) >> generator;
+        out << "Resuming from epoch " << state.epoch << " of " << checkpointPath << std::endl;
+    }
+    else
+    {
+        state.epochs = TrainingEpochs;
+        state.rows = students.size();
+        state.selectedFeatures = selectedFeatures;
+        state.featureMeans = featureMeans;
+        state.featureStdDevs = featureStdDevs;
+        state.weights.assign(houseIndex.size(), std::vector<double>(selectedFeatures.size(), 0.0));
+        std::random_device rd;
+        generator.seed(rd());
+        LogisticRegression::InitializeWeights(state.weights, generator);
+        std::ostringstream generatorState;
+        generatorState << generator;
+        state.generator = generatorState.str();
+    }
+
+    std::vector<std::vector<double>> weights = state.weights;
+    std::vector<std::vector<double>> trainingInputs;
+    std::vector<std::vector<double>> trainingLabels;
+    LogisticRegression::CreateTrainingData(students, inputFeatures, houseIndex, trainingInputs, trainingLabels);
+
+    // Train the model, handing a copy of the state to the writer thread every `interval` epochs
+    {
+        std::optional<Checkpoint::Writer> writer;
+        if (options.interval > 0)
+        {
+            writer.emplace(checkpointPath);
+        }
+        LogisticRegression::TrainModels(weights, trainingInputs, trainingLabels, state.epochs, out, state.epoch,
+            [&](size_t epoch, const std::vector<std::vector<double>>& reached) {
+                if (writer && epoch % options.interval == 0 && epoch < state.epochs)
+                {
+                    state.epoch = epoch;
+                    state.weights = reached;
+                    writer->Submit(state);
+                }
+            });
+    }
+
+    // Save weights and normalization parameters, the checkpoint is not needed anymore
+    Profiler::Phase phase("save");
+    Utils::SaveWeightsAndNormalizationParameters(weights, featureMeans, featureStdDevs, selectedFeatures, modelPath, students.size());
+    std::remove(checkpointPath.c_str());
+}
+
+} // namespace
+
+// Function to train the one-vs-all models and save them
+void Commands::Train(const Dataset& dataset, const std::string& modelPath, std::ostream& out, const CheckpointOptions& checkpoint)
+{
+    // Work on a copy of the selected features, since the students are imputed and normalized in place
+    const std::vector<size_t>& selectedFeatures = LogisticRegression::DefaultSelectedFeatures;
+    const ColumnProjection projection = LogisticRegression::TrainingProjection(selectedFeatures, true);
+    trainSelected(Utils::SelectFeatures(dataset, projection.features, true), selectedFeatures, modelPath, out, checkpoint);
+}
+
+// Function to train the one-vs-all models on a compressed dataset and save them
+void Commands::Train(const CompactDataset& dataset, const std::string& modelPath, std::ostream& out, const CheckpointOptions& checkpoint)
+{
+    const std::vector<size_t>& selectedFeatures = LogisticRegression::DefaultSelectedFeatures;
+    const ColumnProjection projection = LogisticRegression::TrainingProjection(selectedFeatures, true);
+    trainSelected(dataset.SelectFeatures(projection.features, true), selectedFeatures, modelPath, out, checkpoint);
+}
+
+// Function to report the scores on their held-out rows of the models trained on all the other folds
+void Commands::CrossValidate(const Dataset& dataset, size_t folds, std::ostream& out)
+{
+    // Checked before the number of training rows is derived from it
+    if (folds < 2 || folds > dataset.students.size())
+    {
+        throw std::runtime_error("Error: The number of folds must be between 2 and the number of students.");
+    }
+
+    std::random_device rd;
+    const uint64_t seed = rd();
+    Profiler::Phase buildPhase("cv.build", dataset.students.size());
+    const DesignMatrix matrix = CrossValidation::Build(dataset, LogisticRegression::DefaultSelectedFeatures, seed);
+    buildPhase.Stop();
+
+    Profiler::Phase phase("cv.train", matrix.rows * (folds - 1));
+    TrainingSettings settings;
+    settings.epochs = TrainingEpochs;
+    const std::vector<FoldResult> results = CrossValidation::Run(matrix, folds, settings, seed);
+    phase.Stop();
+
+    auto percent = [](double value) {
+        std::ostringstream text;
+        text << std::fixed << std::setprecision(2) << value << "%";
+        return text.str();
+    };
+    out << std::left << std::setw(8) << "Fold" << std::setw(12) << "Training" << std::setw(12) << "Validation"
+        << std::setw(10) << "Accuracy" << "Log-loss" << std::endl;
+    out << std::fixed << std::setprecision(6);
+    double accuracy = 0.0, logLoss = 0.0;
+    for (size_t fold = 0; fold < results.size(); ++fold)
+    {
+        const FoldResult& result = results[fold];
+        out << std::setw(8) << fold + 1 << std::setw(12) << result.trainingRows << std::setw(12) << result.validationRows
+            << std::setw(10) << percent(result.accuracy) << result.logLoss << std::endl;
+        accuracy += result.accuracy / static_cast<double>(results.size());
+        logLoss += result.logLoss / static_cast<double>(results.size());
+    }
+    out << std::setw(32) << "Mean" << std::setw(10) << percent(accuracy) << logLoss << std::endl;
+}
+
+// Function to select the features of the models, then train and save the models on them
+void Commands::SelectFeatures(const Dataset& dataset, const SelectionSettings& settings, const std::string& modelPath, std::ostream& out)
+{
+    std::random_device rd;
+    const uint64_t seed = rd();
+
+    // Every loaded feature is a candidate, by its index (1-based) and its header
+    std::vector<size_t> features;
+    std::vector<std::string> names;
+    for (size_t column : dataset.featureColumns)
+    {
+        features.push_back(column + 1);
+        names.push_back(dataset.headers[dataset.featuresStartIndex + column]);
+    }
+
+    // One imputed and normalized column store, read by every candidate subset
+    Profiler::Phase buildPhase("cv.build", dataset.students.size());
+    DesignMatrix matrix = CrossValidation::Build(dataset, features, seed);
+    if (settings.sampleRows != 0 && settings.sampleRows < matrix.rows)
+    {
+        // The rows are shuffled, so the first ones are a random sample
+        matrix.rows = settings.sampleRows;
+        matrix.values.resize(matrix.rows * matrix.columns);
+        matrix.houses.resize(matrix.rows);
+    }
+    const FoldView fold = CrossValidation::Fold(matrix, 0, 5);
+    const NormalizedColumns store = FeatureSelection::Normalize(fold, CrossValidation::FitScaling(fold));
+    buildPhase.Stop();
+
+    Profiler::Phase phase("select");
+    const std::vector<size_t> candidates = FeatureSelection::PruneCorrelated(store, fold, settings.maxCorrelation);
+    for (size_t feature = 0; feature < features.size(); ++feature)
+    {
+        if (std::find(candidates.begin(), candidates.end(), feature) == candidates.end())
+        {
+            out << "Skipping " << names[feature] << ", correlated with a previous feature" << std::endl;
+        }
+    }
+    FeatureSubset subset = FeatureSelection::Search(store, fold, candidates, names, settings, out);
+    phase.Stop();
+
+    std::vector<size_t> selectedFeatures;
+    for (size_t position : subset.features)
+    {
+        selectedFeatures.push_back(features[position]);
+    }
+    std::sort(selectedFeatures.begin(), selectedFeatures.end());
+    out << "Selected features:";
+    for (size_t feature : selectedFeatures)
+    {
+        out << " " << feature;
+    }
+    out << std::endl;
+
+    // The final models train on every student, as by Train
+    const ColumnProjection projection = LogisticRegression::TrainingProjection(selectedFeatures, true);
+    trainSelected(Utils::SelectFeatures(dataset, projection.features, true), selectedFeatures, modelPath, out, CheckpointOptions());
+}
+
+// Function to compare hyperparameters on held-out students and rank them in a leaderboard
+void Commands::Sweep(const Dataset& dataset, const SweepSpace& space, size_t randomTrials, const std::string& leaderboardPath, std::ostream& out)
+{
+    std::random_device rd;
+    const uint64_t seed = rd();
+    const std::vector<TrainingSettings> settings = randomTrials ? Sweep::Sample(space, randomTrials, seed) : Sweep::Grid(space);
+
+    Profiler::Phase buildPhase("cv.build", dataset.students.size());
+    const DesignMatrix matrix = CrossValidation::Build(dataset, LogisticRegression::DefaultSelectedFeatures, seed);
+    buildPhase.Stop();
+
+    Profiler::Phase phase("sweep", settings.size());
+    const std::vector<SweepTrial> trials = Sweep::Run(matrix, settings, 5, seed);
+    phase.Stop();
+
+    std::ofstream file(leaderboardPath);
+    if (!file.is_open())
+    {
+        throw std::runtime_error("Error: Unable to open the file " + leaderboardPath + " for writing.");
+    }
+    Sweep::WriteLeaderboard(trials, file);
+
+    // Best trials, the others are only in the leaderboard
+    const size_t shown = std::min<size_t>(trials.size(), 10);
+    out << std::left << std::setw(6) << "Rank" << std::setw(15) << "Learning rate" << std::setw(8) << "Epochs"
+        << std::setw(13) << "L2" << std::setw(11) << "Solver" << std::setw(10) << "Accuracy" << std::setw(11) << "Log-loss"
+        << "Seconds" << std::endl;
+    for (size_t i = 0; i < shown; ++i)
+    {
+        const SweepTrial& trial = trials[i];
+        std::ostringstream accuracy;
+        accuracy << std::fixed << std::setprecision(2) << trial.result.accuracy << "%";
+        out << std::setw(6) << i + 1 << std::defaultfloat << std::setprecision(6) << std::setw(15) << trial.settings.learningRate
+            << std::setw(8) << trial.settings.epochs << std::setw(13) << trial.settings.l2
+            << std::setw(11) << TrainingSettings::SolverName(trial.settings.solver) << std::setw(10) << accuracy.str()
+            << std::fixed << std::setw(11) << trial.result.logLoss << std::setprecision(3) << trial.seconds << std::endl;
+    }
+    out << trials.size() << " trials written to " << leaderboardPath << std::endl;
+}
+
+// Function to update the saved models with new students only
+void Commands::PartialFit(const Dataset& dataset, const std::string& modelPath, size_t epochs, bool refreshNormalization, std::ostream& out)
+{
+    // Load the models with their normalization and the features they use
+    std::vector<std::vector<double>> weights;
+    std::vector<double> featureMeans, featureStdDevs;
+    std::vector<size_t> selectedFeatures;
+    size_t normalizationRows = 0;
+    Profiler::Phase modelPhase("load.model");
+    Utils::LoadWeightsAndNormalizationParameters(weights, featureMeans, featureStdDevs, selectedFeatures, modelPath, &normalizationRows);
+    if (weights.empty() || featureMeans.size() != selectedFeatures.size() || weights.size() != LogisticRegression::HousesIndex.size())
+    {
+        throw std::runtime_error("Error: Wrong model file " + modelPath);
+    }
+    if (refreshNormalization && normalizationRows == 0)
+    {
+        throw std::runtime_error("Error: The model file " + modelPath + " does not record the rows of its normalization, train it again to refresh it.");
+    }
+    modelPhase.Stop();
+
+    const ColumnProjection projection = LogisticRegression::TrainingProjection(selectedFeatures, true);
+    std::vector<StudentInfo> students = Utils::SelectFeatures(dataset, projection.features, true);
+
+    // Missing values take the means of the model, as the training imputes before computing the normalization
+    Profiler::Phase imputePhase("impute", students.size());
+    for (auto& student : students)
+    {
+        for (size_t j = 0; j < featureMeans.size(); ++j)
+        {
+            if (std::isnan(student.features[j]))
+            {
+                student.features[j] = featureMeans[j];
+            }
+        }
+    }
+    imputePhase.Stop();
+
+    // Merge the moments of the new students into the ones of the history. The model has no intercept, so only the
+    // slopes follow the new scales, the shift of the means is left to the gradient steps.
+    if (refreshNormalization)
+    {
+        Profiler::Phase phase("normalize.merge", students.size());
+        for (size_t j = 0; j < featureMeans.size(); ++j)
+        {
+            ColumnSummary history;
+            history.count = normalizationRows;
+            history.mean = featureMeans[j];
+            history.sum = featureMeans[j] * static_cast<double>(normalizationRows);
+            history.m2 = featureStdDevs[j] * featureStdDevs[j] * static_cast<double>(normalizationRows);
+            ColumnSummary added;
+            for (const auto& student : students)
+            {
+                ColumnStats::Add(added, student.features[j]);
+            }
+            ColumnStats::Merge(history, added);
+
+            const double stdDev = ColumnStats::StandardDeviation(history);
+            if (featureStdDevs[j] != 0.0 && stdDev != 0.0)
+            {
+                for (auto& houseWeights : weights)
+                {
+                    houseWeights[j] *= stdDev / featureStdDevs[j];
+                }
+            }
+            featureMeans[j] = history.mean;
+            featureStdDevs[j] = stdDev;
+        }
+        normalizationRows += students.size();
+    }
+
+    Utils::NormalizeData(students, featureMeans, featureStdDevs);
+
+    // Continue the training from the saved weights, over the new students only
+    std::vector<size_t> inputFeatures(selectedFeatures.size());
+    std::iota(inputFeatures.begin(), inputFeatures.end(), 1);
+    std::vector<std::vector<double>> trainingInputs;
+    std::vector<std::vector<double>> trainingLabels;
+    LogisticRegression::CreateTrainingData(students, inputFeatures, LogisticRegression::HousesIndex, trainingInputs, trainingLabels);
+    LogisticRegression::TrainModels(weights, trainingInputs, trainingLabels, epochs, out);
+
+    Profiler::Phase phase("save");
+    Utils::SaveWeightsAndNormalizationParameters(weights, featureMeans, featureStdDevs, selectedFeatures, modelPath, normalizationRows);
+}
@@ -0,0 +1,206 @@
+#include "cross_validation.h"
+#include "logreg.h"
+#include "scoring_kernels.h"
+#include "tracer.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+
+namespace {
+
+// Function to write the normalized features of a row to `inputs`
+inline void normalizeRow(const DesignMatrix& matrix, size_t row, const FoldScaling& scaling, double* inputs) {
+    const double* values = matrix.row(row);
+    for (size_t j = 0; j < matrix.columns; ++j) {
+        inputs[j] = std::isnan(values[j]) ? scaling.missing[j] : (values[j] - scaling.offsets[j]) * scaling.scales[j];
+    }
+}
+
+} // namespace
+
+const char* TrainingSettings::SolverName(Solver solver) {
+    switch (solver) {
+    case Solver::MiniBatch:
+        return "minibatch";
+    case Solver::Stochastic:
+        return "sgd";
+    default:
+        return "batch";
+    }
+}
+
+Solver TrainingSettings::ParseSolver(const std::string& name) {
+    for (Solver solver : { Solver::Batch, Solver::MiniBatch, Solver::Stochastic }) {
+        if (name == SolverName(solver)) {
+            return solver;
+        }
+    }
+    throw std::runtime_error("Error: Unknown solver : " + name + " (batch, minibatch or sgd)");
+}
+
+DesignMatrix CrossValidation::Build(const Dataset& dataset, const std::vector<size_t>& selectedFeatures, uint64_t seed) {
+    Tracer::Scope scope("cv.build");
+    std::vector<size_t> positions;
+    for (size_t feature : selectedFeatures) {
+        auto it = std::find(dataset.featureColumns.begin(), dataset.featureColumns.end(), feature - 1);
+        if (it == dataset.featureColumns.end()) {
+            throw std::runtime_error("Error: Feature " + std::to_string(feature) + " was not loaded.");
+        }
+        positions.push_back(static_cast<size_t>(it - dataset.featureColumns.begin()));
+    }
+
+    std::vector<size_t> order(dataset.students.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::mt19937_64 generator(seed);
+    std::shuffle(order.begin(), order.end(), generator);
+
+    DesignMatrix matrix;
+    matrix.rows = order.size();
+    matrix.columns = positions.size();
+    matrix.values.resize(matrix.rows * matrix.columns);
+    matrix.houses.assign(matrix.rows, static_cast<uint8_t>(LogisticRegression::HousesIndex.size()));
+    for (size_t row = 0; row < matrix.rows; ++row) {
+        const StudentInfo& student = dataset.students[order[row]];
+        for (size_t j = 0; j < positions.size(); ++j) {
+            matrix.values[row * matrix.columns + j] = student.features[positions[j]];
+        }
+        for (const auto& [house, name] : LogisticRegression::HousesIndex) {
+            if (!student.labels.empty() && student.labels[0] == name) {
+                matrix.houses[row] = static_cast<uint8_t>(house);
+            }
+        }
+    }
+    return matrix;
+}
+
+FoldView CrossValidation::Fold(const DesignMatrix& matrix, size_t fold, size_t folds) {
+    return FoldView{ &matrix, matrix.rows * fold / folds, matrix.rows * (fold + 1) / folds };
+}
+
+// Missing values are imputed with the mean, which adds no deviation, so they only count in the number of rows.
+// Features without deviation are left as they are, as by Utils::NormalizeData.
+FoldScaling CrossValidation::FitScaling(const FoldView& fold) {
+    const size_t columns = fold.matrix->columns;
+    std::vector<double> means(columns, 0.0), m2(columns, 0.0);
+    std::vector<size_t> counts(columns, 0);
+    fold.forEachTrainingRow([&](size_t row) {
+        const double* values = fold.matrix->row(row);
+        for (size_t j = 0; j < columns; ++j) {
+            if (!std::isnan(values[j])) {
+                const double delta = values[j] - means[j];
+                means[j] += delta / static_cast<double>(++counts[j]);
+                m2[j] += delta * (values[j] - means[j]);
+            }
+        }
+    });
+
+    FoldScaling scaling{ std::vector<double>(columns), std::vector<double>(columns), std::vector<double>(columns) };
+    for (size_t j = 0; j < columns; ++j) {
+        const double stdDev = std::sqrt(m2[j] / static_cast<double>(fold.trainingRows()));
+        const bool scaled = stdDev != 0.0;
+        scaling.offsets[j] = scaled ? means[j] : 0.0;
+        scaling.scales[j] = scaled ? 1.0 / stdDev : 1.0;
+        scaling.missing[j] = scaled ? 0.0 : means[j];
+    }
+    return scaling;
+}
+
+FoldResult CrossValidation::TrainFold(const FoldView& fold, const FoldScaling& scaling, const TrainingSettings& settings, uint64_t seed) {
+    Tracer::Scope scope("cv.fold");
+    const DesignMatrix& matrix = *fold.matrix;
+    const size_t columns = matrix.columns;
+    const size_t housesCount = LogisticRegression::HousesIndex.size();
+
+    std::vector<std::vector<double>> weights(housesCount, std::vector<double>(columns, 0.0));
+    std::mt19937 generator(static_cast<std::mt19937::result_type>(seed));
+    LogisticRegression::InitializeWeights(weights, generator);
+    const ScoringKernels::Set& kernels = ScoringKernels::Select(columns, housesCount);
+
+    // Each row is normalized once per visit and feeds the gradients of every house, which only depend on their own weights
+    std::vector<double> inputs(columns);
+    std::vector<std::vector<double>> gradients(housesCount, std::vector<double>(columns, 0.0));
+    auto accumulate = [&](size_t row) {
+        normalizeRow(matrix, row, scaling, inputs.data());
+        for (size_t house = 0; house < housesCount; ++house) {
+            const double target = matrix.houses[row] == house ? 1.0 : 0.0;
+            const double error = kernels.hypothesis(weights[house].data(), inputs.data(), columns) - target;
+            for (size_t j = 0; j < columns; ++j) {
+                gradients[house][j] += error * inputs[j];
+            }
+        }
+    };
+    auto descend = [&](size_t rows) {
+        const double scale = 1.0 / static_cast<double>(rows);
+        for (size_t house = 0; house < housesCount; ++house) {
+            for (size_t j = 0; j < columns; ++j) {
+                weights[house][j] -= settings.learningRate * (scale * gradients[house][j] + settings.l2 * weights[house][j]);
+                gradients[house][j] = 0.0;
+            }
+        }
+    };
+
+    // The batches are consecutive training rows, which the shuffled matrix already mixes, visited in a new order every epoch
+    const size_t trainingRows = fold.trainingRows();
+    const size_t batchSize = settings.solver == Solver::Stochastic ? 1 : std::max<size_t>(1, settings.batchSize);
+    std::vector<size_t> batches;
+    if (settings.solver != Solver::Batch) {
+        batches.resize((trainingRows + batchSize - 1) / batchSize);
+        std::iota(batches.begin(), batches.end(), 0);
+    }
+    for (size_t epoch = 0; epoch < settings.epochs; ++epoch) {
+        if (settings.solver == Solver::Batch) {
+            fold.forEachTrainingRow(accumulate);
+            descend(trainingRows);
+            continue;
+        }
+        std::shuffle(batches.begin(), batches.end(), generator);
+        for (size_t batch : batches) {
+            const size_t end = std::min(trainingRows, (batch + 1) * batchSize);
+            for (size_t position = batch * batchSize; position < end; ++position) {
+                accumulate(fold.trainingRow(position));
+            }
+            descend(end - batch * batchSize);
+        }
+    }
+
+    // Score the validation rows, with the log-loss of LogisticRegression::LossFunction
+    FoldResult result;
+    result.trainingRows = trainingRows;
+    result.validationRows = fold.validationEnd - fold.validationBegin;
+    size_t correct = 0;
+    double logLikelihood = 0.0;
+    for (size_t row = fold.validationBegin; row < fold.validationEnd; ++row) {
+        normalizeRow(matrix, row, scaling, inputs.data());
+        size_t predictedHouse = 0;
+        double maxProbability = -1.0;
+        for (size_t house = 0; house < housesCount; ++house) {
+            const double probability = kernels.hypothesis(weights[house].data(), inputs.data(), columns);
+            const double target = matrix.houses[row] == house ? 1.0 : 0.0;
+            logLikelihood += target * std::log(probability + 1e-15) + (1.0 - target) * std::log(1.0 - probability + 1e-15);
+            if (probability > maxProbability) {
+                maxProbability = probability;
+                predictedHouse = house;
+            }
+        }
+        correct += matrix.houses[row] == predictedHouse;
+    }
+    const double rows = static_cast<double>(result.validationRows);
+    result.accuracy = 100.0 * static_cast<double>(correct) / rows;
+    result.logLoss = -logLikelihood / (rows * static_cast<double>(housesCount));
+    return result;
+}
+
+std::vector<FoldResult> CrossValidation::Run(const DesignMatrix& matrix, size_t folds, const TrainingSettings& settings, uint64_t seed) {
+    if (folds < 2 || folds > matrix.rows) {
+        throw std::runtime_error("Error: The number of folds must be between 2 and the number of students.");
+    }
+
+    std::vector<FoldResult> results(folds);
+    Utils::ParallelFor(folds, [&](size_t fold) {
+        const FoldView view = Fold(matrix, fold, folds);
+        results[fold] = TrainFold(view, FitScaling(view), settings, seed + fold);
+    });
+    return results;
+}
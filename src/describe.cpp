@@ -1,44 +1,50 @@
 #include "utils.h"
-#include "calculate.h"
+#include "commands.h"
+#include "profiler.h"
 
 int main(int argc, char* argv[])
 {
     try {
-        std::vector<StudentInfo> students;
+        Dataset dataset;
 #ifndef _MSC_VER
 
-        if (argc != 2)
+        CommandLine commandLine = Utils::ParseCommandLine(argc, argv);
+        if (commandLine.positional.size() != 1)
         {
-            std::cerr << "Usage: " << argv[0] << " <dataset>.csv" << std::endl;
+            std::cerr << "Usage: " << argv[0] << " <dataset>.csv [--stats] [--compact[=<tolerance>]] [--float32] [--profile[=<profile>.json]] [--trace[=<trace>.json]] [--perf] [--memory]" << std::endl;
             return 1;
         }
-        Utils::LoadDataFile(argv[1], students);
-#else       
-        Utils::LoadDataFile("dataset_train.csv", students);
-#endif // MVS
-        size_t featuresCount = students[0].features.size();
-        std::vector<std::vector<double>> featuresValues(featuresCount);
-        for (size_t i = 0; i < featuresCount; i++)
+        Profiler::Setup(commandLine);
+
+        // Summaries persisted next to the file, updated with the appended lines only
+        if (commandLine.has("stats"))
+        {
+            Commands::DescribeSummary(ColumnStats::Update(commandLine.positional[0]));
+            return 0;
+        }
+        // Columns compressed within the tolerance, only lossless encodings without one. With --float32 the
+        // remaining doubles are stored as floats: half the bytes for every statistic pass, still summed in doubles
+        if (commandLine.has("compact") || commandLine.has("float32"))
         {
-            for (const auto& student : students)
+            const double tolerance = commandLine.get("compact").empty() ? 0.0 : commandLine.getNumber("compact", 0.0);
+            CompactDataset compact = CompactDataset::Load(commandLine.positional[0], tolerance);
+            if (commandLine.has("float32"))
             {
-                featuresValues[i].push_back(student.features[i]);
+                compact.ToFloat32();
             }
+            Commands::Describe(compact);
+            return 0;
         }
-
-        Utils::printFeatureHeader(featuresValues.size());
-        Utils::computeAndPrintFeatures("Count", [](const auto& data) { return static_cast<double>(data.size()); }, featuresValues);
-        Utils::computeAndPrintFeatures("Mean", Calculate::Mean, featuresValues);
-        Utils::computeAndPrintFeatures("Std", Calculate::StandardDeviation, featuresValues);
-        Utils::computeAndPrintFeatures("Min", Calculate::Min, featuresValues);
-        Utils::computeAndPrintFeatures("25%", std::bind(Calculate::Quartile, std::placeholders::_1, 25), featuresValues);
-        Utils::computeAndPrintFeatures("50%", std::bind(Calculate::Quartile, std::placeholders::_1, 50), featuresValues);
-        Utils::computeAndPrintFeatures("75%", std::bind(Calculate::Quartile, std::placeholders::_1, 75), featuresValues);
-        Utils::computeAndPrintFeatures("Max", Calculate::Max, featuresValues);
+        dataset = Utils::LoadDataset(commandLine.positional[0]);
+#else       
+        dataset = Utils::LoadDataset("dataset_train.csv");
+#endif // MVS
+        Commands::Describe(dataset);
     }
     catch (const std::exception& e) {
-        // Grer les exceptions et afficher les messages d'erreur
+        // Handle exceptions and display error messages
         std::cerr << e.what() << std::endl;
         return EXIT_FAILURE;
     }
-}
\ No newline at end of file
+    return 0;
+}
@@ -0,0 +1,156 @@
+#include <cstring>
+#include <sstream>
+#include <thread>
+#include "utils.h"
+#include "commands.h"
+#include "profiler.h"
+#include "binning.h"
+
+namespace {
+
+// Subcommands of the driver. Names are string literals so that they can name trace regions and threads.
+const char* const CommandNames[] = { "describe", "histogram", "scatter_plot", "pair_plot", "train", "predict" };
+
+// Requested subcommand, with the report it wrote and the error it raised.
+struct CommandRun {
+    const char* name = nullptr;
+    std::ostringstream out;
+    std::string error;
+};
+
+// Options shared by the subcommands.
+struct DriverOptions {
+    size_t histogramBins = 0;
+    size_t pairPlotBins = 24;
+    std::string modelPath = "models.save";
+    std::string outputPath = "houses.csv";
+    // Data file described from its persisted column summaries, empty to describe the loaded dataset.
+    std::string statsPath;
+};
+
+const char* findCommand(const std::string& name) {
+    for (const char* command : CommandNames) {
+        if (name == command) {
+            return command;
+        }
+    }
+    throw std::runtime_error("Error: Unknown command : " + name);
+}
+
+// Function to run one subcommand, writing its report to its own buffer.
+void runCommand(CommandRun& run, const Dataset& data, const Dataset& test, const DriverOptions& options) {
+    Tracer::SetThreadName(run.name);
+    Tracer::Scope scope(run.name);
+    try {
+        if (std::strcmp(run.name, "describe") == 0 && !options.statsPath.empty()) {
+            Commands::DescribeSummary(ColumnStats::Update(options.statsPath), run.out);
+        }
+        else if (std::strcmp(run.name, "describe") == 0) {
+            Commands::Describe(data, run.out);
+        }
+        else if (std::strcmp(run.name, "histogram") == 0) {
+            Commands::Histogram(data, options.histogramBins, run.out);
+        }
+        else if (std::strcmp(run.name, "scatter_plot") == 0) {
+            Commands::ScatterPlot(data, run.out);
+        }
+        else if (std::strcmp(run.name, "pair_plot") == 0) {
+            Commands::PairPlot(data, options.pairPlotBins, run.out);
+        }
+        else if (std::strcmp(run.name, "train") == 0) {
+            Commands::Train(data, options.modelPath, run.out);
+        }
+        else {
+            Commands::Predict(test, options.modelPath, options.outputPath, run.out);
+        }
+    }
+    catch (const std::exception& e) {
+        run.error = e.what();
+    }
+}
+
+// Function to run subcommands concurrently, one thread each, since the plots wait on their Python process.
+void runConcurrently(std::vector<CommandRun*>& runs, const Dataset& data, const Dataset& test, const DriverOptions& options) {
+    std::vector<std::thread> threads;
+    for (CommandRun* run : runs) {
+        threads.emplace_back(runCommand, std::ref(*run), std::cref(data), std::cref(test), std::cref(options));
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    try {
+        CommandLine commandLine = Utils::ParseCommandLine(argc, argv, { "data", "test", "bins", "model", "output" });
+        if (commandLine.positional.empty() || !commandLine.has("data"))
+        {
+            std::cerr << "Usage: " << argv[0] << " <command>... --data=<dataset>.csv [--test=<dataset>.csv] [--bins=<bins>] [--stats]"
+                << " [--model=models.save] [--output=houses.csv] [--profile[=<profile>.json]] [--trace[=<trace>.json]] [--perf] [--memory]" << std::endl;
+            std::cerr << "Commands: describe histogram scatter_plot pair_plot train predict" << std::endl;
+            return 1;
+        }
+
+        std::vector<CommandRun> runs(commandLine.positional.size());
+        bool trainRequested = false;
+        bool predictRequested = false;
+        for (size_t i = 0; i < runs.size(); ++i)
+        {
+            runs[i].name = findCommand(commandLine.positional[i]);
+            trainRequested |= std::strcmp(runs[i].name, "train") == 0;
+            predictRequested |= std::strcmp(runs[i].name, "predict") == 0;
+        }
+
+        DriverOptions options;
+        if (commandLine.has("bins"))
+        {
+            options.histogramBins = options.pairPlotBins = commandLine.getCount("bins", 0, Binning::MaxBins);
+        }
+        options.modelPath = commandLine.get("model", options.modelPath);
+        options.outputPath = commandLine.get("output", options.outputPath);
+        if (commandLine.has("stats"))
+        {
+            options.statsPath = commandLine.get("data");
+        }
+        Profiler::Setup(commandLine);
+
+        // Parse every data file once, all subcommands share it
+        const Dataset data = Utils::LoadDataset(commandLine.get("data"));
+        const bool separateTest = predictRequested && commandLine.has("test");
+        const Dataset test = separateTest ? Utils::LoadDataset(commandLine.get("test")) : Dataset();
+
+        // Predictions read the models saved by the training, so they wait for it when both are requested
+        std::vector<CommandRun*> firstWave, secondWave;
+        for (auto& run : runs)
+        {
+            const bool waitsForTraining = trainRequested && std::strcmp(run.name, "predict") == 0;
+            (waitsForTraining ? secondWave : firstWave).push_back(&run);
+        }
+        runConcurrently(firstWave, data, separateTest ? test : data, options);
+        runConcurrently(secondWave, data, separateTest ? test : data, options);
+
+        // Print the reports in the order of the command line
+        bool failed = false;
+        for (const auto& run : runs)
+        {
+            if (runs.size() > 1)
+            {
+                std::cout << "==> " << run.name << " <==" << std::endl;
+            }
+            std::cout << run.out.str();
+            if (!run.error.empty())
+            {
+                std::cerr << run.name << ": " << run.error << std::endl;
+                failed = true;
+            }
+        }
+        return failed ? EXIT_FAILURE : 0;
+    }
+    catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+}
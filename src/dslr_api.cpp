@@ -0,0 +1,132 @@
+#include "dslr.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "utils.h"
+#include "logreg.h"
+#include "scoring_kernels.h"
+
+struct dslr_model {
+    size_t features = 0;
+    size_t classes = 0;
+    // Weights of every class one after the other.
+    std::vector<double> weights;
+    std::vector<double> means;
+    std::vector<double> standardDeviations;
+    std::vector<std::string> classNames;
+    const ScoringKernels::Set* kernels = nullptr;
+};
+
+namespace {
+
+thread_local std::string lastError;
+
+// Function to record the message of a failure, returning `result`.
+template <typename Result>
+Result fail(const std::string& message, Result result) {
+    lastError = message;
+    return result;
+}
+
+} // namespace
+
+dslr_model* dslr_model_load(const char* path) {
+    if (!path) {
+        return fail("Error: No model path.", nullptr);
+    }
+
+    // Checked here, since the loader reports a missing file on the error output of the process
+    if (!std::ifstream(path).is_open()) {
+        return fail("Error: Unable to open the file " + std::string(path) + " for reading.", nullptr);
+    }
+
+    try {
+        std::vector<std::vector<double>> weights;
+        std::vector<double> means, standardDeviations;
+        std::vector<size_t> selectedFeatures;
+        Utils::LoadWeightsAndNormalizationParameters(weights, means, standardDeviations, selectedFeatures, path);
+        if (weights.empty() || means.size() != selectedFeatures.size() || standardDeviations.size() != selectedFeatures.size()
+            || weights.size() != LogisticRegression::HousesIndex.size()
+            || std::any_of(weights.begin(), weights.end(), [&](const std::vector<double>& w) { return w.size() != selectedFeatures.size(); })) {
+            return fail("Error: Wrong model file " + std::string(path), nullptr);
+        }
+
+        dslr_model* model = new dslr_model;
+        model->features = selectedFeatures.size();
+        model->classes = weights.size();
+        model->weights = ScoringKernels::Flatten(weights);
+        model->means = means;
+        model->standardDeviations = standardDeviations;
+        for (size_t house = 0; house < model->classes; ++house) {
+            model->classNames.push_back(LogisticRegression::HousesIndex.at(house));
+        }
+        model->kernels = &ScoringKernels::Select(model->features, model->classes);
+        return model;
+    }
+    catch (const std::exception& e) {
+        return fail(e.what(), nullptr);
+    }
+}
+
+size_t dslr_model_features(const dslr_model* model) {
+    return model ? model->features : 0;
+}
+
+size_t dslr_model_classes(const dslr_model* model) {
+    return model ? model->classes : 0;
+}
+
+const char* dslr_class_name(const dslr_model* model, int class_index) {
+    if (!model || class_index < 0 || static_cast<size_t>(class_index) >= model->classes) {
+        return nullptr;
+    }
+    return model->classNames[static_cast<size_t>(class_index)].c_str();
+}
+
+int dslr_score_batch(const dslr_model* model, const double* rows, size_t n, int* out_class, double* out_proba) {
+    if (!model || (!rows && n > 0)) {
+        return fail("Error: No model or no rows to score.", -1);
+    }
+
+    // Inputs of one row, on the stack for the models of the specialized kernels.
+    const size_t features = model->features;
+    double stackInputs[ScoringKernels::MaxSpecializedFeatures];
+    std::vector<double> heapInputs(features > ScoringKernels::MaxSpecializedFeatures ? features : 0);
+    double* inputs = features > ScoringKernels::MaxSpecializedFeatures ? heapInputs.data() : stackInputs;
+
+    for (size_t i = 0; i < n; ++i) {
+        // Missing values are imputed with the means of the training data, then every value is normalized.
+        const double* row = rows + i * features;
+        for (size_t j = 0; j < features; ++j) {
+            const double value = std::isnan(row[j]) ? model->means[j] : row[j];
+            inputs[j] = model->standardDeviations[j] != 0.0 ? (value - model->means[j]) / model->standardDeviations[j] : value;
+        }
+
+        double maxProbability = -1.0;
+        int predictedClass = 0;
+        for (size_t house = 0; house < model->classes; ++house) {
+            const double probability = model->kernels->hypothesis(model->weights.data() + house * features, inputs, features);
+            if (probability > maxProbability) {
+                maxProbability = probability;
+                predictedClass = static_cast<int>(house);
+            }
+        }
+        if (out_class) {
+            out_class[i] = predictedClass;
+        }
+        if (out_proba) {
+            out_proba[i] = maxProbability;
+        }
+    }
+    return 0;
+}
+
+void dslr_model_free(dslr_model* model) {
+    delete model;
+}
+
+const char* dslr_last_error(void) {
+    return lastError.c_str();
+}
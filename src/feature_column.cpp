@@ -0,0 +1,330 @@
+#include "feature_column.h"
+#include "profiler.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+
+namespace {
+
+// Function to decode `count` frame of reference offsets of `Width` bytes.
+template <typename Width>
+void decodeOffsets(const uint8_t* offsets, size_t count, double base, double step, double* out) {
+    for (size_t i = 0; i < count; ++i) {
+        Width offset;
+        std::memcpy(&offset, offsets + i * sizeof(Width), sizeof(Width));
+        out[i] = base + static_cast<double>(offset) * step;
+    }
+}
+
+// Rows parsed at once while loading a compact dataset: the students of a chunk are converted to columns before the
+// next one is parsed, so that the rows layout never holds more than a chunk.
+constexpr size_t LoadChunkRows = 1 << 14;
+
+// Function to append a chunk of parsed students to uncompressed columns, releasing the values of each one once copied.
+void appendColumns(CompactDataset& shard, std::vector<StudentInfo>& students) {
+    if (shard.indices.empty() && !students.empty()) {
+        shard.labels.resize(students[0].labels.size());
+        shard.features.resize(students[0].features.size());
+    }
+    for (auto& student : students) {
+        shard.indices.push_back(student.index);
+        for (size_t i = 0; i < shard.labels.size(); ++i) {
+            shard.labels[i].push_back(student.labels[i]);
+        }
+        for (size_t i = 0; i < shard.features.size(); ++i) {
+            shard.features[i].push_back(student.features[i]);
+        }
+        std::vector<std::string>().swap(student.labels);
+        std::vector<double>().swap(student.features);
+    }
+}
+
+} // namespace
+
+void FeatureColumn::push_back(double value) {
+    if (encoding != Encoding::Float64) {
+        throw std::runtime_error("Error: A compressed feature column cannot grow.");
+    }
+    if (rows % BlockSize == 0) {
+        validity.push_back(0);
+    }
+
+    const bool valid = !std::isnan(value);
+    values.push_back(valid ? value : 0.0);
+    validity.back() |= static_cast<uint64_t>(valid) << (rows % BlockSize);
+    rows++;
+}
+
+size_t FeatureColumn::count() const {
+    size_t total = 0;
+    for (uint64_t word : validity) {
+        total += static_cast<size_t>(std::popcount(word));
+    }
+    return total;
+}
+
+const double* FeatureColumn::block(size_t block, double* buffer) const {
+    const size_t begin = block * BlockSize;
+    const size_t count = std::min(BlockSize, rows - begin);
+    switch (encoding) {
+    case Encoding::Float64:
+        return values.data() + begin;
+    case Encoding::Float32:
+        for (size_t i = 0; i < count; ++i) {
+            buffer[i] = static_cast<double>(floats[begin + i]);
+        }
+        break;
+    case Encoding::FrameOfReference:
+        if (offsetWidth == 1) {
+            decodeOffsets<uint8_t>(offsets.data() + begin, count, base, step, buffer);
+        }
+        else if (offsetWidth == 2) {
+            decodeOffsets<uint16_t>(offsets.data() + begin * 2, count, base, step, buffer);
+        }
+        else {
+            decodeOffsets<uint32_t>(offsets.data() + begin * 4, count, base, step, buffer);
+        }
+        break;
+    }
+
+    // Missing rows decode to the base of the frame, they are cleared to keep the reading of the doubles.
+    for (uint64_t missing = ~validity[block] & (count == BlockSize ? ~0ull : (1ull << count) - 1); missing != 0; missing &= missing - 1) {
+        buffer[std::countr_zero(missing)] = 0.0;
+    }
+    return buffer;
+}
+
+void FeatureColumn::Compress(double tolerance) {
+    if (encoding != Encoding::Float64 || rows == 0) {
+        return;
+    }
+
+    double minValue = std::numeric_limits<double>::infinity();
+    double maxValue = -std::numeric_limits<double>::infinity();
+    for (size_t row = 0; row < rows; ++row) {
+        if (isValid(row)) {
+            minValue = std::min(minValue, values[row]);
+            maxValue = std::max(maxValue, values[row]);
+        }
+    }
+    if (minValue > maxValue) {
+        minValue = maxValue = 0.0;
+    }
+
+    // A step of `tolerance` rounds every value by at most half of it, leaving room for the rounding of the decoding.
+    const double range = tolerance > 0.0 ? std::ceil((maxValue - minValue) / tolerance) : std::numeric_limits<double>::infinity();
+    if (range <= static_cast<double>(std::numeric_limits<uint32_t>::max())) {
+        offsetWidth = range <= 255.0 ? 1 : range <= 65535.0 ? 2 : 4;
+        base = minValue;
+        step = tolerance;
+        offsets.assign(rows * offsetWidth, 0);
+        for (size_t row = 0; row < rows; ++row) {
+            const uint32_t offset = isValid(row) ? static_cast<uint32_t>(std::lround((values[row] - base) / step)) : 0;
+            if (offsetWidth == 1) {
+                offsets[row] = static_cast<uint8_t>(offset);
+            }
+            else if (offsetWidth == 2) {
+                const uint16_t narrow = static_cast<uint16_t>(offset);
+                std::memcpy(&offsets[row * 2], &narrow, 2);
+            }
+            else {
+                std::memcpy(&offsets[row * 4], &offset, 4);
+            }
+        }
+        encoding = Encoding::FrameOfReference;
+    }
+    else {
+        bool floatsFit = true;
+        for (size_t row = 0; row < rows && floatsFit; ++row) {
+            floatsFit = std::abs(static_cast<double>(static_cast<float>(values[row])) - values[row]) <= tolerance;
+        }
+        if (!floatsFit) {
+            values.shrink_to_fit();
+            return;
+        }
+        floats.assign(values.begin(), values.end());
+        encoding = Encoding::Float32;
+    }
+    std::vector<double>().swap(values);
+}
+
+void FeatureColumn::ToFloat32() {
+    if (encoding != Encoding::Float64) {
+        return;
+    }
+    floats.assign(values.begin(), values.end());
+    std::vector<double>().swap(values);
+    encoding = Encoding::Float32;
+}
+
+size_t FeatureColumn::MemoryBytes() const {
+    return values.capacity() * sizeof(double) + floats.capacity() * sizeof(float) + offsets.capacity()
+        + validity.capacity() * sizeof(uint64_t);
+}
+
+std::vector<FeatureColumn> FeatureColumn::FromStudents(const std::vector<StudentInfo>& students) {
+    std::vector<FeatureColumn> columns(students.empty() ? 0 : students[0].features.size());
+    for (auto& column : columns) {
+        column.values.reserve(students.size());
+        column.validity.reserve((students.size() + BlockSize - 1) / BlockSize);
+    }
+
+    for (const auto& student : students) {
+        for (size_t i = 0; i < columns.size(); ++i) {
+            columns[i].push_back(student.features[i]);
+        }
+    }
+    return columns;
+}
+
+void LabelColumn::push_back(const std::string& value) {
+    auto [it, inserted] = lookup.try_emplace(value, static_cast<uint32_t>(dictionary.size()));
+    if (inserted) {
+        dictionary.push_back(value);
+    }
+    codes.push_back(it->second);
+}
+
+void LabelColumn::Seal() {
+    std::unordered_map<std::string, uint32_t>().swap(lookup);
+    dictionary.shrink_to_fit();
+    codes.shrink_to_fit();
+}
+
+size_t LabelColumn::MemoryBytes() const {
+    size_t bytes = codes.capacity() * sizeof(uint32_t) + dictionary.capacity() * sizeof(std::string);
+    for (const auto& value : dictionary) {
+        bytes += value.capacity() > 15 ? value.capacity() + 1 : 0;
+    }
+    return bytes;
+}
+
+size_t CompactDataset::MemoryBytes() const {
+    size_t bytes = indices.capacity() * sizeof(size_t);
+    for (const auto& column : labels) {
+        bytes += column.MemoryBytes();
+    }
+    for (const auto& column : features) {
+        bytes += column.MemoryBytes();
+    }
+    return bytes;
+}
+
+CompactDataset CompactDataset::Load(const std::string& filenames, double tolerance, const ColumnProjection* projection) {
+    // Each shard is converted to columns chunk by chunk while it is parsed, so that only a chunk of every shard
+    // being parsed is held as students at once.
+    const std::vector<std::string> files = Utils::ExpandDataFiles(filenames);
+    std::vector<CompactDataset> shards(files.size());
+    Utils::ParallelFor(files.size(), [&](size_t i) {
+        auto [headers, featuresStartIndex] = Utils::LoadDataFileChunks(files[i], LoadChunkRows,
+            [&](std::vector<StudentInfo>& students) { appendColumns(shards[i], students); }, projection);
+        shards[i].headers = std::move(headers);
+        shards[i].featuresStartIndex = featuresStartIndex;
+    });
+
+    // The shards are appended in order, they must share the header of the first one.
+    Profiler::Phase phase("compact");
+    CompactDataset dataset;
+    dataset.headers = shards[0].headers;
+    for (size_t i = 0; i < shards.size(); ++i) {
+        CompactDataset& shard = shards[i];
+        if (shard.headers != dataset.headers) {
+            throw std::runtime_error("Error: The header of " + files[i] + " differs from the one of " + files[0]);
+        }
+        if (shard.indices.empty()) {
+            continue;
+        }
+        if (dataset.indices.empty()) {
+            dataset = std::move(shard);
+            continue;
+        }
+        if (shard.featuresStartIndex != dataset.featuresStartIndex) {
+            throw std::runtime_error("Error: The label columns of " + files[i] + " differ from the ones of the previous shards.");
+        }
+
+        dataset.indices.insert(dataset.indices.end(), shard.indices.begin(), shard.indices.end());
+        for (size_t column = 0; column < shard.labels.size(); ++column) {
+            for (size_t row = 0; row < shard.size(); ++row) {
+                dataset.labels[column].push_back(shard.labels[column][row]);
+            }
+        }
+        for (size_t column = 0; column < shard.features.size(); ++column) {
+            const FeatureColumn& values = shard.features[column];
+            for (size_t row = 0; row < shard.size(); ++row) {
+                dataset.features[column].push_back(values.isValid(row) ? values.values[row] : std::numeric_limits<double>::quiet_NaN());
+            }
+        }
+        shard = CompactDataset();
+    }
+
+    if (dataset.indices.empty()) {
+        throw std::runtime_error("Error: No student in the file " + filenames);
+    }
+
+    Utils::ParallelFor(dataset.features.size(), [&](size_t column) {
+        dataset.features[column].Compress(tolerance);
+    });
+    for (auto& column : dataset.labels) {
+        column.Seal();
+    }
+    dataset.indices.shrink_to_fit();
+    phase.SetRows(dataset.size());
+
+    if (projection) {
+        dataset.featureColumns = projection->features;
+    }
+    else {
+        dataset.featureColumns.resize(dataset.headers.size() - dataset.featuresStartIndex);
+        std::iota(dataset.featureColumns.begin(), dataset.featureColumns.end(), 0);
+    }
+    Profiler::AddCounter("compact_bytes", static_cast<double>(dataset.MemoryBytes()));
+    return dataset;
+}
+
+void CompactDataset::ToFloat32() {
+    const double bytes = static_cast<double>(MemoryBytes());
+    Utils::ParallelFor(features.size(), [&](size_t column) {
+        features[column].ToFloat32();
+    });
+    // The counter accumulates, it is given the bytes saved
+    Profiler::AddCounter("compact_bytes", static_cast<double>(MemoryBytes()) - bytes);
+}
+
+std::vector<StudentInfo> CompactDataset::SelectFeatures(const std::vector<size_t>& selectedColumns, bool keepLabels) const {
+    std::vector<size_t> positions;
+    for (size_t column : selectedColumns) {
+        auto it = std::find(featureColumns.begin(), featureColumns.end(), column);
+        if (it == featureColumns.end()) {
+            throw std::runtime_error("Error: Feature " + std::to_string(column + 1) + " was not loaded.");
+        }
+        positions.push_back(static_cast<size_t>(it - featureColumns.begin()));
+    }
+
+    std::vector<StudentInfo> students(size());
+    for (size_t row = 0; row < students.size(); ++row) {
+        students[row].index = indices[row];
+        students[row].features.resize(positions.size());
+        if (keepLabels) {
+            for (const auto& column : labels) {
+                students[row].labels.push_back(column[row]);
+            }
+        }
+    }
+
+    double buffer[FeatureColumn::BlockSize];
+    for (size_t k = 0; k < positions.size(); ++k) {
+        const FeatureColumn& column = features[positions[k]];
+        for (size_t block = 0; block < column.validity.size(); ++block) {
+            const double* values = column.block(block, buffer);
+            const size_t begin = block * FeatureColumn::BlockSize;
+            const size_t count = std::min(FeatureColumn::BlockSize, column.size() - begin);
+            for (size_t i = 0; i < count; ++i) {
+                students[begin + i].features[k] = (column.validity[block] >> i) & 1 ? values[i] : std::numeric_limits<double>::quiet_NaN();
+            }
+        }
+    }
+    return students;
+}
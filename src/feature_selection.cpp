@@ -0,0 +1,225 @@
+#include "feature_selection.h"
+#include "logreg.h"
+#include "scoring_kernels.h"
+#include "thread_pool.h"
+#include "tracer.h"
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+
+// Function to return the names of the features of a subset
+std::string subsetNames(const std::vector<size_t>& features, const std::vector<std::string>& names) {
+    std::string text;
+    for (size_t feature : features) {
+        text += (text.empty() ? "" : ", ") + names[feature];
+    }
+    return text.empty() ? "(none)" : text;
+}
+
+} // namespace
+
+SelectionMethod FeatureSelection::ParseMethod(const std::string& name) {
+    if (name.empty() || name == "forward") {
+        return SelectionMethod::Forward;
+    }
+    if (name == "backward") {
+        return SelectionMethod::Backward;
+    }
+    throw std::runtime_error("Error: Unknown selection method : " + name + " (forward or backward)");
+}
+
+NormalizedColumns FeatureSelection::Normalize(const FoldView& fold, const FoldScaling& scaling) {
+    Tracer::Scope scope("select.normalize");
+    const DesignMatrix& matrix = *fold.matrix;
+    NormalizedColumns store;
+    store.rows = matrix.rows;
+    store.houses = matrix.houses;
+    store.columns.assign(matrix.columns, std::vector<double>(matrix.rows));
+    for (size_t row = 0; row < matrix.rows; ++row) {
+        const double* values = matrix.row(row);
+        for (size_t j = 0; j < matrix.columns; ++j) {
+            store.columns[j][row] = std::isnan(values[j]) ? scaling.missing[j] : (values[j] - scaling.offsets[j]) * scaling.scales[j];
+        }
+    }
+    return store;
+}
+
+std::vector<size_t> FeatureSelection::PruneCorrelated(const NormalizedColumns& store, const FoldView& fold, double maxCorrelation) {
+    // The normalized columns have a zero mean over the training rows, so their correlation is the cosine of their angle
+    auto dot = [&](size_t a, size_t b) {
+        double sum = 0.0;
+        fold.forEachTrainingRow([&](size_t row) {
+            sum += store.columns[a][row] * store.columns[b][row];
+        });
+        return sum;
+    };
+
+    std::vector<size_t> kept;
+    std::vector<double> norms(store.columns.size());
+    for (size_t feature = 0; feature < store.columns.size(); ++feature) {
+        norms[feature] = std::sqrt(dot(feature, feature));
+        bool redundant = false;
+        for (size_t other : kept) {
+            const double norms2 = norms[feature] * norms[other];
+            if (norms2 > 0.0 && std::abs(dot(feature, other)) / norms2 > maxCorrelation) {
+                redundant = true;
+                break;
+            }
+        }
+        if (!redundant) {
+            kept.push_back(feature);
+        }
+    }
+    return kept;
+}
+
+FeatureSubset FeatureSelection::Train(const NormalizedColumns& store, const FoldView& fold, std::vector<size_t> features,
+    std::vector<std::vector<double>> weights, const SelectionSettings& settings) {
+    Tracer::Scope scope("select.candidate");
+    const size_t columns = features.size();
+    const size_t housesCount = weights.size();
+    const ScoringKernels::Set& kernels = ScoringKernels::Select(columns, housesCount);
+
+    std::vector<double> inputs(columns);
+    auto gather = [&](size_t row) {
+        for (size_t j = 0; j < columns; ++j) {
+            inputs[j] = store.columns[features[j]][row];
+        }
+    };
+
+    // Full batch gradient descent, as by LogisticRegression::TrainModels
+    std::vector<std::vector<double>> gradients(housesCount, std::vector<double>(columns, 0.0));
+    const double step = settings.learningRate / static_cast<double>(fold.trainingRows());
+    for (size_t epoch = 0; epoch < settings.epochs; ++epoch) {
+        fold.forEachTrainingRow([&](size_t row) {
+            gather(row);
+            for (size_t house = 0; house < housesCount; ++house) {
+                const double target = store.houses[row] == house ? 1.0 : 0.0;
+                const double error = kernels.hypothesis(weights[house].data(), inputs.data(), columns) - target;
+                for (size_t j = 0; j < columns; ++j) {
+                    gradients[house][j] += error * inputs[j];
+                }
+            }
+        });
+        for (size_t house = 0; house < housesCount; ++house) {
+            for (size_t j = 0; j < columns; ++j) {
+                weights[house][j] -= step * gradients[house][j];
+                gradients[house][j] = 0.0;
+            }
+        }
+    }
+
+    FeatureSubset subset;
+    subset.result.trainingRows = fold.trainingRows();
+    subset.result.validationRows = fold.validationEnd - fold.validationBegin;
+    size_t correct = 0;
+    double logLikelihood = 0.0;
+    for (size_t row = fold.validationBegin; row < fold.validationEnd; ++row) {
+        gather(row);
+        size_t predictedHouse = 0;
+        double maxProbability = -1.0;
+        for (size_t house = 0; house < housesCount; ++house) {
+            const double probability = kernels.hypothesis(weights[house].data(), inputs.data(), columns);
+            const double target = store.houses[row] == house ? 1.0 : 0.0;
+            logLikelihood += target * std::log(probability + 1e-15) + (1.0 - target) * std::log(1.0 - probability + 1e-15);
+            if (probability > maxProbability) {
+                maxProbability = probability;
+                predictedHouse = house;
+            }
+        }
+        correct += store.houses[row] == predictedHouse;
+    }
+    const double rows = static_cast<double>(subset.result.validationRows);
+    subset.result.accuracy = 100.0 * static_cast<double>(correct) / rows;
+    subset.result.logLoss = -logLikelihood / (rows * static_cast<double>(housesCount));
+    subset.features = std::move(features);
+    subset.weights = std::move(weights);
+    return subset;
+}
+
+FeatureSubset FeatureSelection::Search(const NormalizedColumns& store, const FoldView& fold, const std::vector<size_t>& candidates,
+    const std::vector<std::string>& names, const SelectionSettings& settings, std::ostream& out) {
+    if (candidates.empty()) {
+        throw std::runtime_error("Error: No feature to select from.");
+    }
+
+    const size_t housesCount = LogisticRegression::HousesIndex.size();
+    const bool forward = settings.method == SelectionMethod::Forward;
+    ThreadPool pool;
+
+    // The search starts from no feature or from all of them, with zero weights
+    FeatureSubset current;
+    current.features = forward ? std::vector<size_t>() : candidates;
+    current.weights.assign(housesCount, std::vector<double>(current.features.size(), 0.0));
+    current = Train(store, fold, current.features, current.weights, settings);
+
+    out << std::left << std::setw(6) << "Step" << std::setw(10) << "Accuracy" << std::setw(11) << "Log-loss" << "Change" << std::endl;
+    auto printStep = [&](size_t step, const FeatureSubset& subset, const std::string& change) {
+        std::ostringstream accuracy;
+        accuracy << std::fixed << std::setprecision(2) << subset.result.accuracy << "%";
+        out << std::setw(6) << step << std::setw(10) << accuracy.str() << std::fixed << std::setprecision(6)
+            << std::setw(11) << subset.result.logLoss << change << std::endl;
+    };
+    printStep(0, current, forward ? "(none)" : subsetNames(current.features, names));
+
+    for (size_t step = 1;; ++step) {
+        // Every child starts from the weights of the parent, a new feature from 0. The parent itself trains for as
+        // many epochs, so that the children are compared with it at the same training budget.
+        std::vector<FeatureSubset> children(1, current);
+        if (forward) {
+            for (size_t feature : candidates) {
+                if (std::find(current.features.begin(), current.features.end(), feature) == current.features.end()) {
+                    FeatureSubset child = current;
+                    child.features.push_back(feature);
+                    for (auto& houseWeights : child.weights) {
+                        houseWeights.push_back(0.0);
+                    }
+                    children.push_back(std::move(child));
+                }
+            }
+        }
+        else if (current.features.size() > 1) {
+            for (size_t position = 0; position < current.features.size(); ++position) {
+                FeatureSubset child = current;
+                child.features.erase(child.features.begin() + static_cast<std::ptrdiff_t>(position));
+                for (auto& houseWeights : child.weights) {
+                    houseWeights.erase(houseWeights.begin() + static_cast<std::ptrdiff_t>(position));
+                }
+                children.push_back(std::move(child));
+            }
+        }
+
+        for (size_t i = 0; i < children.size(); ++i) {
+            pool.Submit([&, i] {
+                children[i] = Train(store, fold, std::move(children[i].features), std::move(children[i].weights), settings);
+            });
+        }
+        pool.Wait();
+
+        const FeatureSubset& parent = children[0];
+        auto best = std::min_element(children.begin() + 1, children.end(), [](const FeatureSubset& a, const FeatureSubset& b) {
+            return a.result.logLoss < b.result.logLoss;
+        });
+        // Forward steps must lower the log-loss, backward steps must not raise it, by more than the tolerance. The
+        // first forward step is always taken, a model needs at least one feature.
+        const bool accepted = best != children.end() && (forward
+            ? current.features.empty() || best->result.logLoss < parent.result.logLoss * (1.0 - settings.tolerance)
+            : best->result.logLoss <= parent.result.logLoss * (1.0 + settings.tolerance));
+        if (!accepted) {
+            return parent;
+        }
+
+        // Additions are appended to the features, removals keep their order
+        size_t changed = best->features.back();
+        if (!forward) {
+            const auto removed = std::mismatch(best->features.begin(), best->features.end(), current.features.begin());
+            changed = *removed.second;
+        }
+        printStep(step, *best, (forward ? "+ " : "- ") + names[changed]);
+        current = std::move(*best);
+    }
+}
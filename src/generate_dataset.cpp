@@ -0,0 +1,50 @@
+#include <chrono>
+#include "utils.h"
+#include "synthetic.h"
+#include "profiler.h"
+
+int main(int argc, char* argv[])
+{
+    try {
+        CommandLine commandLine = Utils::ParseCommandLine(argc, argv, { "rows", "features", "separation", "nan", "seed" });
+
+        if (commandLine.positional.size() != 1)
+        {
+            std::cerr << "Usage: " << argv[0] << " <output> [--rows=1600] [--features=13] [--separation=2] [--nan=0] [--seed=42] [--test] [--binary] [--profile[=<profile>.json]] [--trace[=<trace>.json]] [--perf] [--memory]" << std::endl;
+            return 1;
+        }
+        Profiler::Setup(commandLine);
+
+        SyntheticOptions options;
+        options.rows = commandLine.getCount("rows", options.rows);
+        options.features = commandLine.getCount("features", options.features);
+        options.separation = commandLine.getNumber("separation", options.separation);
+        options.nanRate = commandLine.getNumber("nan", options.nanRate);
+        options.seed = commandLine.getCount("seed", options.seed);
+        options.testSet = commandLine.has("test");
+
+        if (options.rows == 0 || options.features == 0 || options.nanRate < 0.0 || options.nanRate > 1.0)
+        {
+            throw std::runtime_error("Error: Wrong dataset parameters");
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        if (commandLine.has("binary"))
+        {
+            Synthetic::WriteBinary(commandLine.positional[0], options);
+        }
+        else
+        {
+            Synthetic::WriteCsv(commandLine.positional[0], options);
+        }
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        std::cerr << "Wrote " << options.rows << " rows of " << options.features << " courses to "
+            << commandLine.positional[0] << " in " << std::fixed << std::setprecision(2) << elapsed.count() << "s" << std::endl;
+    }
+    catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    return 0;
+}
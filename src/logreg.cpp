@@ -0,0 +1,357 @@
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+#include "logreg.h"
+#include "calculate.h"
+#include "profiler.h"
+#include "scoring_kernels.h"
+#include "output_writer.h"
+
+// Mapping of house indices
+const std::unordered_map<size_t, std::string> LogisticRegression::HousesIndex = {
+    {0, "Slytherin"},
+    {1, "Ravenclaw"},
+    {2, "Gryffindor"},
+    {3, "Hufflepuff"},
+};
+
+const std::vector<size_t> LogisticRegression::DefaultSelectedFeatures = { 3, 4, 7 };
+
+// Function to build the projection of the columns used by the models
+ColumnProjection LogisticRegression::TrainingProjection(const std::vector<size_t>& selectedFeatures, bool withHouse)
+{
+    ColumnProjection projection;
+    if (withHouse)
+    {
+        projection.labels.push_back(0);
+    }
+    for (size_t feature : selectedFeatures)
+    {
+        projection.features.push_back(feature - 1);
+    }
+    return projection;
+}
+
+double LogisticRegression::LossFunction(const std::vector<std::vector<double>>& inputs, const std::vector<std::vector<double>>& weights,
+    const std::vector<std::vector<double>>& target, const size_t house)
+{
+    const size_t size = inputs.size();
+    const size_t featuresCount = weights[house].size();
+    const ScoringKernels::Set& kernels = ScoringKernels::Select(featuresCount, weights.size());
+    double loss = kernels.logLikelihood(inputs, target, house, weights[house].data(), featuresCount);
+    return - (1.0 / size) * loss;
+}
+
+void LogisticRegression::GradientDescent(const std::vector<std::vector<double>>& inputs, std::vector<std::vector<double>>& weights,
+    const std::vector<std::vector<double>>& target, const size_t house)
+{
+    const double learningRate = 0.1;
+    const size_t size = weights[0].size();
+
+    // Toutes les drives partielles sont calcules en un seul passage sur les lignes, avant la mise  jour des poids
+    std::vector<double> derivatives(size);
+    const ScoringKernels::Set& kernels = ScoringKernels::Select(size, weights.size());
+    kernels.gradient(inputs, target, house, weights[house].data(), size, derivatives.data());
+
+    for (size_t j = 0; j < size; j++)
+    {
+        weights[house][j] -= learningRate * derivatives[j];
+    }
+}
+
+void LogisticRegression::TrainModels(std::vector<std::vector<double>>& weights, const std::vector<std::vector<double>>& inputs,
+    const std::vector<std::vector<double>>& targets, const size_t epochs, std::ostream& out, const size_t firstEpoch,
+    const EpochCallback& onEpoch)
+{
+    const size_t housesCount = weights.size();
+
+    out << std::left << std::setw(std::to_string(epochs).length() + 8) << "Epochs"
+        << std::setw(10) << "Loss 1"
+        << std::setw(10) << "Loss 2"
+        << std::setw(10) << "Loss 3"
+        << std::setw(10) << "Loss 4"
+        << std::setw(10) << "Accuracy" << std::endl;
+    // Approximate floating-point operations of an epoch, counting 2 per multiply-add of the weighted sums:
+    // the gradient, loss and accuracy evaluate every hypothesis once each, and the gradient adds one multiply-add per weight.
+    const double rows = static_cast<double>(inputs.size());
+    const double weightsCount = housesCount ? static_cast<double>(weights[0].size()) : 0.0;
+    const double epochFlops = static_cast<double>(housesCount) * rows * (3.0 * (2.0 * weightsCount + 4.0) + 2.0 * weightsCount);
+
+    // Entranement du modle
+    for (size_t epoch = firstEpoch; epoch < epochs; ++epoch)
+    {
+        Profiler::Phase phase("train.epoch", inputs.size());
+        Profiler::AddCounter("flops", epochFlops);
+        for (size_t house = 0; house < housesCount; house++)
+        {
+            GradientDescent(inputs, weights, targets, house);
+        }
+        // Calculer la perte moyenne pour chaque maison aprs chaque poque (facultatif)
+        out << "Epoch " << std::left << std::setw(std::to_string(epochs).length() + 2) << epoch + 1;
+        for (size_t house = 0; house < housesCount; house++)
+        {
+            double loss = LossFunction(inputs, weights, targets, house);
+            out << std::setw(10) << std::setprecision(6) << loss; 
+        }
+        double accuracy = Calculate::Accuracy(inputs, targets, weights);
+        out << std::setw(5) << std::fixed << std::setprecision(2) << accuracy << "%";
+        out << std::endl;
+        if (onEpoch)
+        {
+            onEpoch(epoch + 1, weights);
+        }
+    }
+}
+
+// Function to handle missing values by replacing NaN with given values
+void LogisticRegression::HandleMissingValues(std::vector<StudentInfo>& students, const std::vector<double>& featureValues)
+{
+    Profiler::Phase phase("impute", students.size());
+    for (auto& student : students)
+    {
+        for (size_t j = 0; j < featureValues.size(); ++j)
+        {
+            if (std::isnan(student.features[j]))
+            {
+                student.features[j] = featureValues[j];
+            }
+        }
+    }
+}
+
+// Function to handle missing values by replacing NaN with feature means
+void LogisticRegression::HandleMissingValues(std::vector<StudentInfo>& students)
+{
+    Profiler::Phase phase("impute", students.size());
+    size_t studentCount = students.size();
+    size_t featureCount = students[0].features.size();
+    std::vector<double> featureMeans(featureCount);
+    for (size_t i = 0; i < featureCount; ++i)
+    {
+        std::vector<double> featureValues(studentCount);
+        for (size_t j = 0; j < studentCount; ++j)
+        {
+            featureValues[j] = students[j].features[i];
+        }
+        featureMeans[i] = Calculate::Mean(featureValues);
+    }
+
+    for (auto& student : students)
+    {
+        for (size_t j = 0; j < featureCount; ++j)
+        {
+            if (std::isnan(student.features[j]))
+            {
+                student.features[j] = featureMeans[j];
+            }
+        }
+    }
+}
+
+// Function to set up data for training
+void LogisticRegression::SetupTrainingData(const std::vector<StudentInfo>& students,
+    const std::vector<size_t>& selectedFeatures,
+    const std::unordered_map<size_t, std::string>& houseIndex,
+    std::vector<std::vector<double>>& weights,
+    std::vector<std::vector<double>>& trainingInputs,
+    std::vector<std::vector<double>>& trainingLabels) {
+    // Initialize weights randomly
+    std::random_device rd;
+    std::mt19937 gen(rd());
+    InitializeWeights(weights, gen);
+
+    CreateTrainingData(students, selectedFeatures, houseIndex, trainingInputs, trainingLabels);
+}
+
+// Function to draw every weight uniformly in [-0.5, 0.5)
+void LogisticRegression::InitializeWeights(std::vector<std::vector<double>>& weights, std::mt19937& generator) {
+    std::uniform_real_distribution<double> distribution(-0.5, 0.5);
+
+    for (auto& houseWeights : weights) {
+        for (auto& weight : houseWeights) {
+            weight = distribution(generator);
+        }
+    }
+}
+
+// Function to build the inputs and labels of the training data
+void LogisticRegression::CreateTrainingData(const std::vector<StudentInfo>& students,
+    const std::vector<size_t>& selectedFeatures,
+    const std::unordered_map<size_t, std::string>& houseIndex,
+    std::vector<std::vector<double>>& trainingInputs,
+    std::vector<std::vector<double>>& trainingLabels) {
+    const size_t houseCount = houseIndex.size();
+
+    // Populate training data
+    for (size_t i = 0; i < students.size(); i++) {
+        std::vector<double> selection;
+        for (auto feature : selectedFeatures) {
+            selection.push_back(students[i].features[feature - 1]);
+        }
+        trainingInputs.push_back(selection);
+
+        std::vector<double> result(houseCount, 0.0);
+        for (const auto& entry : houseIndex) {
+            if (entry.second == students[i].labels[0]) {
+                result[entry.first] = 1.0;
+                break;
+            }
+        }
+        trainingLabels.push_back(result);
+    }
+}
+
+// Function to create input vectors
+void LogisticRegression::CreateInputVectors(const std::vector<StudentInfo>& students,
+    const std::vector<size_t>& featuresSelected,
+    std::vector<std::vector<double>>& inputs)
+{
+    for (const auto& student : students) {
+        std::vector<double> selection;
+        for (auto feature : featuresSelected) {
+            selection.push_back(student.features[feature - 1]);
+        }
+        inputs.push_back(selection);
+    }
+}
+
+// Function to perform predictions and write results to a CSV file
+void LogisticRegression::PerformPredictions(const std::vector<StudentInfo>& students,
+    const std::vector<std::vector<double>>& weights,
+    const std::vector<std::string>& headers,
+    const std::vector<std::vector<double>>& inputs,
+    const std::string& outputPath)
+{
+    OutputWriter output(outputPath);
+    output.Append(headers[0]);
+    output.Append(',');
+    output.Append(headers[1]);
+    output.Append('\n');
+
+    // Chaque lot est crit ds qu'il est prdit, le fil d'criture vide les tampons pendant que les lots suivants sont prdits
+    std::vector<std::string_view> houseNames(HousesIndex.size());
+    for (const auto& [house, name] : HousesIndex) {
+        houseNames[house] = name;
+    }
+    {
+        Profiler::Phase phase("score", students.size());
+        const size_t featuresCount = weights.empty() ? 0 : weights[0].size();
+        const ScoringKernels::Set& kernels = ScoringKernels::Select(featuresCount, weights.size());
+        const std::vector<double> flatWeights = ScoringKernels::Flatten(weights);
+        const size_t batchSize = 4096;
+        size_t predictedHouses[batchSize];
+        for (size_t batchStart = 0; batchStart < students.size(); batchStart += batchSize) {
+            Tracer::Scope scope("score.batch");
+            const size_t batchEnd = std::min(students.size(), batchStart + batchSize);
+            kernels.predict(inputs, batchStart, batchEnd, flatWeights.data(), featuresCount, weights.size(), predictedHouses);
+            for (size_t i = batchStart; i < batchEnd; ++i) {
+                output.Append(students[i].index);
+                output.Append(',');
+                output.Append(houseNames[predictedHouses[i - batchStart]]);
+                output.Append('\n');
+            }
+        }
+        Profiler::AddCounter("rows_scored", static_cast<double>(students.size()));
+    }
+
+    Profiler::Phase phase("output");
+    output.Close();
+}
+
+// Function to write a C++ header scoring rows with a model, without loading nor allocating anything
+void LogisticRegression::WriteScorer(const std::vector<std::vector<double>>& weights,
+    const std::vector<double>& featureMeans,
+    const std::vector<double>& featureStdDevs,
+    const std::vector<size_t>& selectedFeatures,
+    const std::string& name,
+    std::ostream& out)
+{
+    // Les constantes sont crites avec 17 chiffres significatifs, pour relire exactement les mmes doubles
+    auto writeArray = [&](const std::vector<double>& values) {
+        out << "{";
+        for (size_t i = 0; i < values.size(); ++i)
+        {
+            out << (i ? ", " : " ") << std::setprecision(17) << values[i];
+        }
+        out << " }";
+    };
+
+    std::string guard = name + "_H";
+    std::transform(guard.begin(), guard.end(), guard.begin(), [](unsigned char c) { return std::isalnum(c) ? std::toupper(c) : '_'; });
+
+    out << "// Generated by logreg_compile, do not edit.\n"
+        << "#ifndef " << guard << "\n"
+        << "#define " << guard << "\n\n"
+        << "#include <cstddef>\n\n"
+        << "namespace " << name << " {\n\n"
+        << "inline constexpr std::size_t FeaturesCount = " << selectedFeatures.size() << ";\n"
+        << "inline constexpr std::size_t HousesCount = " << weights.size() << ";\n\n"
+        << "// Feature columns read by the model, as 0-based indices among the feature columns of the data files.\n"
+        << "inline constexpr std::size_t SelectedFeatures[FeaturesCount] = {";
+    for (size_t i = 0; i < selectedFeatures.size(); ++i)
+    {
+        out << (i ? ", " : " ") << selectedFeatures[i] - 1;
+    }
+    out << " };\n\n"
+        << "// Normalization of the features, skipped for a zero standard deviation.\n"
+        << "inline constexpr double Means[FeaturesCount] = ";
+    writeArray(featureMeans);
+    out << ";\n"
+        << "inline constexpr double StandardDeviations[FeaturesCount] = ";
+    writeArray(featureStdDevs);
+    out << ";\n\n"
+        << "// Values of the missing features: the means of the training data.\n"
+        << "inline constexpr double ImputationValues[FeaturesCount] = ";
+    writeArray(featureMeans);
+    out << ";\n\n"
+        << "inline constexpr double Weights[HousesCount][FeaturesCount] = {\n";
+    for (const auto& houseWeights : weights)
+    {
+        out << "    ";
+        writeArray(houseWeights);
+        out << ",\n";
+    }
+    out << "};\n\n"
+        << "inline constexpr const char* Houses[HousesCount] = {";
+    for (size_t house = 0; house < weights.size(); ++house)
+    {
+        out << (house ? ", " : " ") << "\"" << HousesIndex.at(house) << "\"";
+    }
+    out << " };\n\n"
+        << "// Return the index in Houses of the most probable house of a row, given every feature column of the data files\n"
+        << "// (NaN when missing). The sigmoid being increasing, it is the house of the largest weighted sum.\n"
+        << "constexpr std::size_t score(const double* row)\n"
+        << "{\n"
+        << "    double inputs[FeaturesCount] = {};\n"
+        << "    for (std::size_t j = 0; j < FeaturesCount; ++j)\n"
+        << "    {\n"
+        << "        const double value = row[SelectedFeatures[j]];\n"
+        << "        inputs[j] = value != value ? ImputationValues[j] : value;\n"
+        << "        if (StandardDeviations[j] != 0.0)\n"
+        << "        {\n"
+        << "            inputs[j] = (inputs[j] - Means[j]) / StandardDeviations[j];\n"
+        << "        }\n"
+        << "    }\n\n"
+        << "    std::size_t predictedHouse = 0;\n"
+        << "    double maxSum = 0.0;\n"
+        << "    for (std::size_t house = 0; house < HousesCount; ++house)\n"
+        << "    {\n"
+        << "        double sum = 0.0;\n"
+        << "        for (std::size_t j = 0; j < FeaturesCount; ++j)\n"
+        << "        {\n"
+        << "            sum += Weights[house][j] * inputs[j];\n"
+        << "        }\n"
+        << "        if (house == 0 || sum > maxSum)\n"
+        << "        {\n"
+        << "            maxSum = sum;\n"
+        << "            predictedHouse = house;\n"
+        << "        }\n"
+        << "    }\n"
+        << "    return predictedHouse;\n"
+        << "}\n\n"
+        << "} // namespace " << name << "\n\n"
+        << "#endif // " << guard << "\n";
+}
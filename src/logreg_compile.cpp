@@ -0,0 +1,51 @@
+#include <fstream>
+#include "utils.h"
+#include "logreg.h"
+#include "profiler.h"
+
+int main(int argc, char* argv[])
+{
+    try {
+        CommandLine commandLine = Utils::ParseCommandLine(argc, argv, { "output", "namespace" });
+        if (commandLine.positional.size() != 1)
+        {
+            std::cerr << "Usage: " << argv[0] << " <model>.save [--output=scorer.h] [--namespace=dslr_model]"
+                << " [--profile[=<profile>.json]] [--trace[=<trace>.json]] [--perf] [--memory]" << std::endl;
+            return 1;
+        }
+        Profiler::Setup(commandLine);
+
+        // Load the models with the features they use
+        const std::string modelPath = commandLine.positional[0];
+        std::vector<std::vector<double>> weights;
+        std::vector<double> featureMeans, featureStdDevs;
+        std::vector<size_t> selectedFeatures;
+        Utils::LoadWeightsAndNormalizationParameters(weights, featureMeans, featureStdDevs, selectedFeatures, modelPath);
+        if (weights.empty() || featureMeans.size() != selectedFeatures.size() || featureStdDevs.size() != selectedFeatures.size()
+            || weights.size() != LogisticRegression::HousesIndex.size())
+        {
+            throw std::runtime_error("Error: Wrong model file " + modelPath);
+        }
+
+        // Write the scorer header
+        const std::string outputPath = commandLine.get("output", "scorer.h");
+        std::ofstream output(outputPath);
+        if (!output.is_open())
+        {
+            throw std::runtime_error("Error: Unable to open the file " + outputPath + " for writing.");
+        }
+        LogisticRegression::WriteScorer(weights, featureMeans, featureStdDevs, selectedFeatures,
+            commandLine.get("namespace", "dslr_model"), output);
+        output.close();
+        if (!output)
+        {
+            throw std::runtime_error("Error: Unable to write the file " + outputPath);
+        }
+    }
+    catch (const std::exception& e) {
+        // Handle exceptions and display error messages
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    return 0;
+}
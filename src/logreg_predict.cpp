@@ -1,128 +1,51 @@
-#include <iostream>
-#include <vector>
-#include <cmath>
-#include <numeric>
-#include <fstream>
-#include <unordered_map>
+#include <algorithm>
 #include "utils.h"
-#include "calculate.h"
+#include "commands.h"
+#include "profiler.h"
+#include "logreg.h"
 
-// Function to handle missing values by replacing NaN with the mean
-void handleMissingValues(std::vector<StudentInfo>& students)
+int main(int argc, char* argv[])
 {
-    // Collect feature values
-    std::vector<std::vector<double>> featureValues(13, std::vector<double>(students.size()));
-    for (size_t i = 0; i < 13; ++i) {
-        for (size_t j = 0; j < students.size(); ++j) {
-            featureValues[i][j] = students[j].features[i];
-        }
-    }
-
-    for (auto& student : students)
-    {
-        for (size_t j = 0; j < student.features.size(); ++j)
-        {
-            if (std::isnan(student.features[j]))
-            {
-                student.features[j] = Calculate::Mean(featureValues[j]);
-            }
-        }
-    }
-}
-
-// Function to create input vectors
-void createInputVectors(const std::vector<StudentInfo>& students,
-    const std::vector<size_t>& featuresSelected,
-    std::vector<std::vector<double>>& inputs)
-{
-    for (const auto& student : students) {
-        std::vector<double> selection;
-        for (auto feature : featuresSelected) {
-            selection.push_back(student.features[feature - 1]);
-        }
-        inputs.push_back(selection);
-    }
-}
-
-// Function to perform predictions and write results to a CSV file
-void performPredictions(const std::vector<StudentInfo>& students,
-    const std::vector<std::vector<double>>& weights,
-    const std::vector<std::string>& headers,
-    const std::vector<std::vector<double>>& inputs)
-{
-    std::ofstream outputFile("houses.csv");
-    if (!outputFile.is_open()) {
-        throw std::runtime_error("Impossible d'ouvrir le fichier de sortie.");
-    }
-
-    // Mapping of house indices
-    std::unordered_map<size_t, std::string> housesIndex = {
-        {0, "Slytherin"},
-        {1, "Ravenclaw"},
-        {2, "Gryffindor"},
-        {3, "Hufflepuff"},
-    };
-
-    outputFile << headers[0] << "," << headers[1] <<std::endl;
-
-    for (size_t i = 0; i < students.size(); ++i) {
-        double maxProbability = 0;
-        size_t predictedHouse = 0;
-
-        for (size_t house = 0; house < weights.size(); ++house) {
-            double probability = Calculate::LogisticRegressionHypothesis(weights[house], inputs[i]);
-            if (probability > maxProbability) {
-                maxProbability = probability;
-                predictedHouse = house;
-            }
-        }
-        outputFile << students[i].index << "," << housesIndex.at(predictedHouse) << std::endl;
-    }
-
-    outputFile.close();
-}
-
-int main(int argc, char* argv[]) {
     try {
-        std::vector<StudentInfo> students;
+        Dataset dataset;
 #ifndef _MSC_VER
 
-        if (argc != 2)
+        CommandLine commandLine = Utils::ParseCommandLine(argc, argv, { "models", "output" });
+        if (commandLine.positional.size() != 1)
         {
-            std::cerr << "Usage: " << argv[0] << " <dataset>.csv" << std::endl;
+            std::cerr << "Usage: " << argv[0] << " <dataset>.csv [--models=models.save[,<model>.save...]] [--output=houses.csv] [--profile[=<profile>.json]] [--trace[=<trace>.json]] [--perf] [--memory]" << std::endl;
             return 1;
         }
-        auto headers = Utils::LoadDataFile(argv[1], students).first;
+        Profiler::Setup(commandLine);
+        // Only the features of the models are parsed, once for all of them
+        const std::vector<std::string> modelPaths = commandLine.getList("models", { "models.save" });
+        const std::string outputPath = commandLine.get("output", "houses.csv");
+        std::vector<size_t> features;
+        for (const std::string& modelPath : modelPaths)
+        {
+            const std::vector<size_t> modelFeatures = Utils::LoadSelectedFeatures(modelPath);
+            features.insert(features.end(), modelFeatures.begin(), modelFeatures.end());
+        }
+        std::sort(features.begin(), features.end());
+        features.erase(std::unique(features.begin(), features.end()), features.end());
+        const ColumnProjection projection = LogisticRegression::TrainingProjection(features, false);
+        dataset = Utils::LoadDataset(commandLine.positional[0], &projection);
+        if (modelPaths.size() > 1)
+        {
+            Commands::PredictModels(dataset, modelPaths, outputPath);
+            return 0;
+        }
+        Commands::Predict(dataset, modelPaths[0], outputPath);
+        return 0;
 #else       
-        auto headers = Utils::LoadDataFile("dataset_train.csv", students).first;
+        dataset = Utils::LoadDataset("dataset_train.csv");
 #endif // MVS
-
-        std::vector<size_t> featuresSelected = { 3, 4, 7 };
-        const size_t featuresCount = featuresSelected.size();
-        const size_t housesCount = 4;
-
-        // Initialize parameters
-        std::vector<std::vector<double>> weights(housesCount, std::vector<double>(featuresCount, 0.0));
-        std::vector<double> featureMeans, featureStdDevs;
-        Utils::LoadWeightsAndNormalizationParameters(weights, featureMeans, featureStdDevs, "models.save");
-
-        // Handle missing values
-        handleMissingValues(students);
-
-        // Normalize data
-        Utils::NormalizeData(students, featureMeans, featureStdDevs);
-
-        // Create input vectors
-        std::vector<std::vector<double>> inputs;
-        createInputVectors(students, featuresSelected, inputs);
-
-        // Perform predictions and write results
-        performPredictions(students, weights, headers, inputs);
+        Commands::Predict(dataset);
     }
     catch (const std::exception& e) {
+        // Handle exceptions and display error messages
         std::cerr << e.what() << std::endl;
         return EXIT_FAILURE;
     }
-
     return 0;
 }
@@ -1,201 +1,91 @@
-#include <iostream>
-#include <vector>
-#include <cmath>
-#include <numeric>
 #include "utils.h"
-#include "calculate.h"
+#include "commands.h"
+#include "profiler.h"
+#include "logreg.h"
 
-#include <random>
-
-double lossFunction(const std::vector<std::vector<double>>& inputs, const std::vector<std::vector<double>>& weights,
-    const std::vector<std::vector<double>>& target, const size_t house)
-{
-    const size_t size = inputs.size();
-    double loss = 0;
-
-    for (size_t i = 0; i < size; ++i)
-    {
-        double proba = Calculate::LogisticRegressionHypothesis(weights[house], inputs[i]);
-        loss += target[i][house] * std::log(proba + 1e-15) +
-            (1.0 - target[i][house]) * std::log(1.0 - proba + 1e-15);
-    }
-    return - (1.0 / size) * loss;
-}
-
-double lossFunctionPartialDerivative(const std::vector<std::vector<double>>& inputs, std::vector<std::vector<double>>& weights,
-    const std::vector<std::vector<double>>& target, const size_t house, const size_t j)
+int main(int argc, char* argv[])
 {
-    const size_t size = inputs.size();
-    double derivative = 0;
-
-    for (size_t i = 0; i < size; i++)
-    {
-        double proba = Calculate::LogisticRegressionHypothesis(weights[house], inputs[i]);
-        derivative += (proba - target[i][house]) * inputs[i][j];
-    }
-    return (1.0 / size) * derivative;
-}
-
-void gradientDescent(const std::vector<std::vector<double>>& inputs, std::vector<std::vector<double>>& weights,
-    const std::vector<std::vector<double>>& target, const size_t house)
-{
-    const double learningRate = 0.1;
-    const size_t size = weights[0].size();
-
-    std::vector<std::vector<double>> tmp_weights = weights;
-    tmp_weights[house][0] = weights[house][0];
-
-    for (size_t j = 0; j < size; j++)
-    {       
-        double derivative = lossFunctionPartialDerivative(inputs, weights, target, house, j);
-        
-        tmp_weights[house][j] -= learningRate * derivative;
-    }
-
-    // Mise  jour des poids aprs avoir calcul toutes les drives partielles
-    weights[house] = tmp_weights[house];
-}
-
-void trainModels(std::vector<std::vector<double>>& weights, const std::vector<std::vector<double>>& inputs,
-    const std::vector<std::vector<double>>& targets, const size_t epochs)
-{
-    const size_t housesCount = weights.size();
+    try {
+        Dataset dataset;
+        CheckpointOptions checkpoint;
+#ifndef _MSC_VER
 
-    std::cout << std::left << std::setw(std::to_string(epochs).length() + 8) << "Epochs"
-        << std::setw(10) << "Loss 1"
-        << std::setw(10) << "Loss 2"
-        << std::setw(10) << "Loss 3"
-        << std::setw(10) << "Loss 4"
-        << std::setw(10) << "Accuracy" << std::endl;
-    // Entranement du modle
-    for (size_t epoch = 0; epoch < epochs; ++epoch)
-    {
-        for (size_t house = 0; house < housesCount; house++)
+        CommandLine commandLine = Utils::ParseCommandLine(argc, argv, { "epochs", "checkpoint-every", "cv", "learning-rates", "l2", "solvers", "trials", "leaderboard", "max-correlation", "sample" });
+        if (commandLine.positional.size() != 1)
         {
-            gradientDescent(inputs, weights, targets, house);
+            std::cerr << "Usage: " << argv[0] << " <dataset>.csv [--compact[=<tolerance>]] [--cv <folds>] [--select-features[=forward|backward] [--epochs=30] [--max-correlation=0.95] [--sample=50000]] [--sweep [--learning-rates=<rates>] [--epochs=<epochs>] [--l2=<strengths>] [--solvers=batch,minibatch,sgd] [--trials=<count>] [--leaderboard=leaderboard.json]] [--update [--epochs=10] [--refresh-normalization]] [--checkpoint-every=<epochs>] [--resume] [--profile[=<profile>.json]] [--trace[=<trace>.json]] [--perf] [--memory]" << std::endl;
+            return 1;
         }
-        // Calculer la perte moyenne pour chaque maison aprs chaque poque (facultatif)
-        std::cout << "Epoch " << std::left << std::setw(std::to_string(epochs).length() + 2) << epoch + 1;
-        for (size_t house = 0; house < housesCount; house++)
+        Profiler::Setup(commandLine);
+
+        // Checkpoints of the training state, every 10 epochs by default when resuming
+        checkpoint.resume = commandLine.has("resume");
+        checkpoint.interval = static_cast<size_t>(commandLine.getNumber("checkpoint-every", checkpoint.resume ? 10.0 : 0.0));
+
+        // Incremental update of the saved models from new students only
+        if (commandLine.has("update"))
         {
-            double loss = lossFunction(inputs, weights, targets, house);
-            std::cout << std::setw(10) << std::setprecision(6) << loss; 
+            const std::string modelPath = "models.save";
+            const ColumnProjection updateProjection = LogisticRegression::TrainingProjection(Utils::LoadSelectedFeatures(modelPath), true);
+            Commands::PartialFit(Utils::LoadDataset(commandLine.positional[0], &updateProjection), modelPath,
+                static_cast<size_t>(commandLine.getNumber("epochs", 10.0)), commandLine.has("refresh-normalization"));
+            return 0;
         }
-        double accuracy = Calculate::Accuracy(inputs, targets, weights);
-        std::cout << std::setw(5) << std::fixed << std::setprecision(2) << accuracy << "%";
-        std::cout << std::endl;
-    }
-}
-
-// Function to handle missing values by replacing NaN with feature means
-void handleMissingValues(std::vector<StudentInfo>& students)
-{
-    size_t studentCount = students.size();
-    size_t featureCount = students[0].features.size();
-    std::vector<std::vector<double>> featureValues(featureCount, std::vector<double>(students.size()));
-    for (size_t i = 0; i < featureCount; ++i)
-    {
-        for (size_t j = 0; j < studentCount; ++j)
+        // Features chosen by a stepwise search over all of them, then saved with the models
+        if (commandLine.has("select-features"))
         {
-            featureValues[i][j] = students[j].features[i];
+            SelectionSettings settings;
+            settings.method = FeatureSelection::ParseMethod(commandLine.get("select-features"));
+            settings.epochs = static_cast<size_t>(commandLine.getNumber("epochs", static_cast<double>(settings.epochs)));
+            settings.maxCorrelation = commandLine.getNumber("max-correlation", settings.maxCorrelation);
+            settings.sampleRows = static_cast<size_t>(commandLine.getNumber("sample", static_cast<double>(settings.sampleRows)));
+            Commands::SelectFeatures(Utils::LoadDataset(commandLine.positional[0]), settings);
+            return 0;
         }
-    }
-
-    for (auto& student : students)
-    {
-        for (size_t j = 0; j < featureCount; ++j)
+        // Only the house and the trained features are parsed
+        const ColumnProjection projection = LogisticRegression::TrainingProjection(LogisticRegression::DefaultSelectedFeatures, true);
+        // Comparison of hyperparameters given as comma-separated lists, every combination or `trials` random ones
+        if (commandLine.has("sweep"))
         {
-            if (std::isnan(student.features[j]))
+            SweepSpace space;
+            space.learningRates = commandLine.getNumbers("learning-rates", space.learningRates);
+            space.l2 = commandLine.getNumbers("l2", space.l2);
+            space.epochs.clear();
+            for (double epochs : commandLine.getNumbers("epochs", { 100.0 }))
             {
-                student.features[j] = Calculate::Mean(featureValues[j]);
+                space.epochs.push_back(static_cast<size_t>(epochs));
             }
-        }
-    }
-}
-
-// Function to set up data for training
-void setupTrainingData(const std::vector<StudentInfo>& students,
-    const std::vector<size_t>& selectedFeatures,
-    const std::unordered_map<size_t, std::string>& houseIndex,
-    std::vector<std::vector<double>>& weights,
-    std::vector<std::vector<double>>& trainingInputs,
-    std::vector<std::vector<double>>& trainingLabels) {
-    const size_t houseCount = houseIndex.size();
-
-    // Initialize weights randomly
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_real_distribution<double> distribution(-0.5, 0.5);
-
-    for (size_t i = 0; i < houseCount; ++i) {
-        for (size_t j = 0; j < selectedFeatures.size(); ++j) {
-            weights[i][j] = distribution(gen);
-        }
-    }
-
-    // Populate training data
-    for (size_t i = 0; i < students.size(); i++) {
-        std::vector<double> selection;
-        for (auto feature : selectedFeatures) {
-            selection.push_back(students[i].features[feature - 1]);
-        }
-        trainingInputs.push_back(selection);
-
-        std::vector<double> result(houseCount, 0.0);
-        for (const auto& entry : houseIndex) {
-            if (entry.second == students[i].labels[0]) {
-                result[entry.first] = 1.0;
-                break;
+            space.solvers.clear();
+            for (const std::string& solver : commandLine.getList("solvers", { "batch" }))
+            {
+                space.solvers.push_back(TrainingSettings::ParseSolver(solver));
             }
+            Commands::Sweep(Utils::LoadDataset(commandLine.positional[0], &projection), space,
+                static_cast<size_t>(commandLine.getNumber("trials", 0.0)), commandLine.get("leaderboard", "leaderboard.json"));
+            return 0;
         }
-        trainingLabels.push_back(result);
-    }
-}
-
-int main(int argc, char* argv[]) {
-    try {
-        std::vector<StudentInfo> students;
-#ifndef _MSC_VER
-
-        if (argc != 2)
+        // Scores of the models on held-out folds, without saving them
+        if (commandLine.has("cv"))
         {
-            std::cerr << "Usage: " << argv[0] << " <dataset>.csv" << std::endl;
-            return 1;
+            Commands::CrossValidate(Utils::LoadDataset(commandLine.positional[0], &projection),
+                static_cast<size_t>(commandLine.getNumber("cv", 5.0)));
+            return 0;
+        }
+        // Columns compressed within the tolerance, only lossless encodings without one
+        if (commandLine.has("compact"))
+        {
+            const double tolerance = commandLine.get("compact").empty() ? 0.0 : commandLine.getNumber("compact", 0.0);
+            Commands::Train(CompactDataset::Load(commandLine.positional[0], tolerance, &projection), "models.save", std::cout, checkpoint);
+            return 0;
         }
-        auto [headers, featuresStartIndex] = Utils::LoadDataFile(argv[1], students);
+        dataset = Utils::LoadDataset(commandLine.positional[0], &projection);
 #else       
-        auto [headers, featuresStartIndex] = Utils::LoadDataFile("dataset_train.csv", students);
+        dataset = Utils::LoadDataset("dataset_train.csv");
 #endif // MVS
-
-        // Handle missing values
-        handleMissingValues(students);
-
-        // Normalize training data
-        std::vector<double> featureMeans, featureStdDevs;
-        Utils::NormalizeData(students, featureMeans, featureStdDevs);
-
-        // Set up data for training
-        std::vector<size_t> selectedFeatures = { 3, 4, 7 };
-        std::unordered_map<size_t, std::string> houseIndex = {
-            {0, "Slytherin"},
-            {1, "Ravenclaw"},
-            {2, "Gryffindor"},
-            {3, "Hufflepuff"}
-        };
-
-        std::vector<std::vector<double>> weights(houseIndex.size(), std::vector<double>(selectedFeatures.size(), 0.0));
-        std::vector<std::vector<double>> trainingInputs;
-        std::vector<std::vector<double>> trainingLabels;
-
-        setupTrainingData(students, selectedFeatures, houseIndex, weights, trainingInputs, trainingLabels);
-
-        // Train the model
-        trainModels(weights, trainingInputs, trainingLabels, 100);
-
-        // Save weights and normalization parameters
-        Utils::SaveWeightsAndNormalizationParameters(weights, featureMeans, featureStdDevs, "models.save");
+        Commands::Train(dataset, "models.save", std::cout, checkpoint);
     }
     catch (const std::exception& e) {
+        // Handle exceptions and display error messages
         std::cerr << e.what() << std::endl;
         return EXIT_FAILURE;
     }
@@ -0,0 +1,120 @@
+#include "memory_profiler.h"
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+// Replacements of the global allocation functions, linked into the programs only: a library embedded in another
+// process must not replace its allocator. Without them the memory profiler counts no allocation.
+
+namespace {
+
+// Function to allocate memory for the operators new, which throw std::bad_alloc when `nothrow` is false.
+void* allocate(size_t size, size_t alignment, bool nothrow) {
+    if (size == 0) {
+        size = 1;
+    }
+
+    void* pointer = nullptr;
+    while (true) {
+        if (alignment > alignof(std::max_align_t)) {
+            if (posix_memalign(&pointer, alignment, size) != 0) {
+                pointer = nullptr;
+            }
+        }
+        else {
+            pointer = std::malloc(size);
+        }
+        if (pointer) {
+            break;
+        }
+
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) {
+            if (nothrow) {
+                return nullptr;
+            }
+            throw std::bad_alloc();
+        }
+        handler();
+    }
+
+    MemoryProfiler::RecordAllocation(size);
+    return pointer;
+}
+
+void deallocate(void* pointer) {
+    if (pointer) {
+        MemoryProfiler::RecordDeallocation();
+        std::free(pointer);
+    }
+}
+
+} // namespace
+
+// Replaced global allocation functions, counting every allocation of the program.
+void* operator new(size_t size) {
+    return allocate(size, 0, false);
+}
+
+void* operator new[](size_t size) {
+    return allocate(size, 0, false);
+}
+
+// The new handler may throw std::bad_alloc even for the nothrow operators, which must then return a null pointer.
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return allocate(size, 0, true);
+    }
+    catch (...) {
+        return nullptr;
+    }
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return allocate(size, 0, true);
+    }
+    catch (...) {
+        return nullptr;
+    }
+}
+
+void* operator new(size_t size, std::align_val_t alignment) {
+    return allocate(size, static_cast<size_t>(alignment), false);
+}
+
+void* operator new[](size_t size, std::align_val_t alignment) {
+    return allocate(size, static_cast<size_t>(alignment), false);
+}
+
+void operator delete(void* pointer) noexcept {
+    deallocate(pointer);
+}
+
+void operator delete[](void* pointer) noexcept {
+    deallocate(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept {
+    deallocate(pointer);
+}
+
+void operator delete[](void* pointer, size_t) noexcept {
+    deallocate(pointer);
+}
+
+void operator delete(void* pointer, std::align_val_t) noexcept {
+    deallocate(pointer);
+}
+
+void operator delete[](void* pointer, std::align_val_t) noexcept {
+    deallocate(pointer);
+}
+
+void operator delete(void* pointer, size_t, std::align_val_t) noexcept {
+    deallocate(pointer);
+}
+
+void operator delete[](void* pointer, size_t, std::align_val_t) noexcept {
+    deallocate(pointer);
+}
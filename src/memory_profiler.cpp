@@ -0,0 +1,56 @@
+#include "memory_profiler.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+MemoryProfiler::Sample MemoryProfiler::Sample::operator-(const Sample& start) const {
+    Sample delta;
+    delta.allocations = allocations - start.allocations;
+    delta.deallocations = deallocations - start.deallocations;
+    delta.bytes = bytes - start.bytes;
+    return delta;
+}
+
+void MemoryProfiler::Enable() {
+    enabled = true;
+}
+
+MemoryProfiler::Sample MemoryProfiler::Read() {
+    Sample sample;
+    sample.allocations = allocations.load(std::memory_order_relaxed);
+    sample.deallocations = deallocations.load(std::memory_order_relaxed);
+    sample.bytes = bytes.load(std::memory_order_relaxed);
+    return sample;
+}
+
+void MemoryProfiler::RecordAllocation(size_t size) {
+    if (Enabled()) {
+        allocations.fetch_add(1, std::memory_order_relaxed);
+        bytes.fetch_add(size, std::memory_order_relaxed);
+    }
+}
+
+void MemoryProfiler::RecordDeallocation() {
+    if (Enabled()) {
+        deallocations.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+uint64_t MemoryProfiler::ProcessPeakResidentBytes() {
+    // Read with stdio on a stack buffer, so that sampling does not count as an allocation of the phase.
+    std::FILE* file = std::fopen("/proc/self/status", "r");
+    if (!file) {
+        return 0;
+    }
+
+    char line[256];
+    uint64_t peak = 0;
+    while (std::fgets(line, sizeof(line), file)) {
+        if (std::strncmp(line, "VmHWM:", 6) == 0) {
+            peak = std::strtoull(line + 6, nullptr, 10) * 1024;
+            break;
+        }
+    }
+    std::fclose(file);
+    return peak;
+}
@@ -0,0 +1,105 @@
+#include "output_writer.h"
+#include "tracer.h"
+#include <charconv>
+#include <cstring>
+#include <stdexcept>
+
+OutputWriter::OutputWriter(const std::string& path, size_t bufferSize) : path(path) {
+    file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        throw std::runtime_error("Error: Unable to open the file " + path + " for writing.");
+    }
+    // The buffers are already large, the stream adds no copy of its own
+    std::setvbuf(file, nullptr, _IONBF, 0);
+    buffers[0].resize(bufferSize);
+    buffers[1].resize(bufferSize);
+    thread = std::thread(&OutputWriter::run, this);
+}
+
+OutputWriter::~OutputWriter() {
+    if (file) {
+        try {
+            Close();
+        }
+        catch (const std::exception&) {
+        }
+    }
+}
+
+void OutputWriter::Append(std::string_view text) {
+    while (used + text.size() > buffers[current].size()) {
+        // Text longer than the free space is split across buffers
+        const size_t part = buffers[current].size() - used;
+        std::memcpy(buffers[current].data() + used, text.data(), part);
+        used += part;
+        text.remove_prefix(part);
+        swapBuffers();
+    }
+    std::memcpy(buffers[current].data() + used, text.data(), text.size());
+    used += text.size();
+}
+
+void OutputWriter::Append(char character) {
+    if (used == buffers[current].size()) {
+        swapBuffers();
+    }
+    buffers[current][used++] = character;
+}
+
+void OutputWriter::Append(size_t value) {
+    char digits[24];
+    const auto result = std::to_chars(digits, digits + sizeof(digits), value);
+    Append(std::string_view(digits, static_cast<size_t>(result.ptr - digits)));
+}
+
+void OutputWriter::Close() {
+    swapBuffers();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    changed.notify_all();
+    thread.join();
+
+    const bool closed = std::fclose(file) == 0;
+    file = nullptr;
+    if (failed || !closed) {
+        throw std::runtime_error("Error: Unable to write the file " + path);
+    }
+}
+
+void OutputWriter::swapBuffers() {
+    std::unique_lock<std::mutex> lock(mutex);
+    changed.wait(lock, [this] { return pendingBytes == 0; });
+    pendingBuffer = current;
+    pendingBytes = used;
+    current = 1 - current;
+    used = 0;
+    lock.unlock();
+    changed.notify_all();
+}
+
+void OutputWriter::run() {
+    Tracer::SetThreadName("output.writer");
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        changed.wait(lock, [this] { return pendingBytes != 0 || stopping; });
+        if (pendingBytes == 0) {
+            return;
+        }
+
+        // The buffer handed over is not touched by the callers until pendingBytes is back to 0
+        const char* data = buffers[pendingBuffer].data();
+        const size_t size = pendingBytes;
+        lock.unlock();
+        bool written;
+        {
+            Tracer::Scope scope("output.write");
+            written = std::fwrite(data, 1, size, file) == size;
+        }
+        lock.lock();
+        failed |= !written;
+        pendingBytes = 0;
+        changed.notify_all();
+    }
+}
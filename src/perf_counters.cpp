@@ -0,0 +1,167 @@
+#include "perf_counters.h"
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif // __linux__
+
+namespace {
+
+const char* const EventNames[PerfCounters::EventsCount] = { "cycles", "instructions", "llc_misses", "branch_misses", "vector_instructions" };
+
+#ifdef __linux__
+
+// Counters of one thread, opened as a group led by the cycles counter so that they are read with one system call.
+struct ThreadCounters {
+    int leader = -1;
+    // Events of the group, in their reading order.
+    std::vector<size_t> events;
+    std::vector<int> descriptors;
+    int error = 0;
+
+    ThreadCounters();
+    ~ThreadCounters();
+};
+
+// Function to check if the processor counts vector instructions with the Intel FP_ARITH_INST_RETIRED event.
+bool hasIntelVectorEvent() {
+    std::ifstream cpuinfo("/proc/cpuinfo");
+    std::string line;
+    while (std::getline(cpuinfo, line)) {
+        if (line.rfind("vendor_id", 0) == 0) {
+            return line.find("GenuineIntel") != std::string::npos;
+        }
+    }
+    return false;
+}
+
+// Function to open one counter of the calling thread, in user space only.
+int openCounter(uint32_t type, uint64_t config, int groupFd) {
+    perf_event_attr attributes;
+    std::memset(&attributes, 0, sizeof(attributes));
+    attributes.size = sizeof(attributes);
+    attributes.type = type;
+    attributes.config = config;
+    attributes.disabled = groupFd == -1;
+    attributes.exclude_kernel = 1;
+    attributes.exclude_hv = 1;
+    attributes.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    return static_cast<int>(syscall(SYS_perf_event_open, &attributes, 0, -1, groupFd, 0));
+}
+
+ThreadCounters::ThreadCounters() {
+    static const bool vectorEvent = hasIntelVectorEvent();
+    const struct { size_t event; uint32_t type; uint64_t config; } definitions[] = {
+        { PerfCounters::Cycles, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+        { PerfCounters::Instructions, PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+        { PerfCounters::CacheMisses, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES },
+        { PerfCounters::BranchMisses, PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+        // FP_ARITH_INST_RETIRED with the packed double umasks (128, 256 and 512 bits).
+        { PerfCounters::VectorInstructions, PERF_TYPE_RAW, 0x54C7 },
+    };
+
+    for (const auto& definition : definitions) {
+        if (definition.event == PerfCounters::VectorInstructions && !vectorEvent) {
+            continue;
+        }
+
+        const int fd = openCounter(definition.type, definition.config, leader);
+        if (fd == -1) {
+            if (leader == -1) {
+                error = errno;
+                return;
+            }
+            continue;
+        }
+
+        if (leader == -1) {
+            leader = fd;
+        }
+        events.push_back(definition.event);
+        descriptors.push_back(fd);
+    }
+
+    ioctl(leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+}
+
+ThreadCounters::~ThreadCounters() {
+    for (int fd : descriptors) {
+        close(fd);
+    }
+}
+
+ThreadCounters& threadCounters() {
+    thread_local ThreadCounters counters;
+    return counters;
+}
+
+#endif // __linux__
+
+} // namespace
+
+PerfCounters::Sample PerfCounters::Sample::operator-(const Sample& start) const {
+    Sample delta;
+    for (size_t i = 0; i < EventsCount; ++i) {
+        delta.available[i] = available[i] && start.available[i];
+        delta.values[i] = delta.available[i] && values[i] > start.values[i] ? values[i] - start.values[i] : 0;
+    }
+    delta.workerTasks = workerTasks - start.workerTasks;
+    return delta;
+}
+
+const char* PerfCounters::EventName(size_t event) {
+    return EventNames[event];
+}
+
+bool PerfCounters::Enable() {
+#ifdef __linux__
+    ThreadCounters& counters = threadCounters();
+    if (counters.leader == -1) {
+        std::cerr << "Warning: Hardware performance counters are unavailable (" << std::strerror(counters.error)
+            << "), --perf ignored." << std::endl;
+        return false;
+    }
+    enabled = true;
+    return true;
+#else
+    std::cerr << "Warning: Hardware performance counters are only supported on Linux, --perf ignored." << std::endl;
+    return false;
+#endif // __linux__
+}
+
+PerfCounters::Sample PerfCounters::Read() {
+    Sample sample;
+    sample.workerTasks = workerTasks.load(std::memory_order_relaxed);
+
+#ifdef __linux__
+    ThreadCounters& counters = threadCounters();
+    if (counters.leader == -1) {
+        return sample;
+    }
+
+    // Group layout: count, time enabled, time running, then one value per event.
+    uint64_t buffer[3 + EventsCount];
+    if (read(counters.leader, buffer, sizeof(buffer)) < static_cast<ssize_t>(3 * sizeof(uint64_t))) {
+        return sample;
+    }
+
+    // Scale the counts when the kernel multiplexed the group with other events.
+    const double scale = buffer[2] > 0 ? static_cast<double>(buffer[1]) / static_cast<double>(buffer[2]) : 1.0;
+    for (size_t i = 0; i < buffer[0] && i < counters.events.size(); ++i) {
+        sample.values[counters.events[i]] = static_cast<uint64_t>(static_cast<double>(buffer[3 + i]) * scale);
+        sample.available[counters.events[i]] = true;
+    }
+#endif // __linux__
+
+    return sample;
+}
@@ -0,0 +1,335 @@
+#include "profiler.h"
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+// Accumulated durations of a phase.
+struct PhaseStats {
+    std::string name;
+    size_t calls = 0;
+    double seconds = 0.0;
+    double minSeconds = 0.0;
+    double maxSeconds = 0.0;
+    size_t rows = 0;
+    PerfCounters::Sample counters;
+    MemoryProfiler::Sample memory;
+    // Largest process-wide high-water mark seen at the end of the phase, not a peak of the phase alone.
+    uint64_t processPeakBytes = 0;
+};
+
+// Phases and counters recorded since the profiler was enabled, in order of first appearance.
+struct ProfileData {
+    std::mutex mutex;
+    Profiler::Clock::time_point start;
+    std::vector<PhaseStats> phases;
+    std::unordered_map<std::string, size_t> phasesIndex;
+    std::vector<std::pair<std::string, double>> counters;
+    std::string jsonPath;
+};
+
+ProfileData& profileData() {
+    static ProfileData data;
+    return data;
+}
+
+// Rates derived from a counter and the total duration of a phase, printed when both were recorded.
+struct DerivedRate {
+    const char* name;
+    const char* counter;
+    const char* phase;
+    double scale;
+};
+
+const DerivedRate DerivedRates[] = {
+    { "read MB/s", "bytes_read", "load", 1e-6 },
+    { "parsed rows/s", "rows_parsed", "load.parse", 1.0 },
+    { "training GFLOP/s", "flops", "train.epoch", 1e-9 },
+    { "scored rows/s", "rows_scored", "score", 1.0 },
+};
+
+double wallSeconds(const ProfileData& data) {
+    return std::chrono::duration<double>(Profiler::Clock::now() - data.start).count();
+}
+
+const PhaseStats* findPhase(const ProfileData& data, const std::string& name) {
+    auto it = data.phasesIndex.find(name);
+    return it == data.phasesIndex.end() ? nullptr : &data.phases[it->second];
+}
+
+const double* findCounter(const ProfileData& data, const std::string& name) {
+    for (const auto& counter : data.counters) {
+        if (counter.first == name) {
+            return &counter.second;
+        }
+    }
+    return nullptr;
+}
+
+// Function to print the hardware counters of every phase: instructions per cycle, then misses per row
+// for the phases that processed rows, or in total otherwise. The phases during which worker threads ran tasks are
+// marked, since only the thread running the phase is counted.
+void printCountersSummary(std::ostream& out, const ProfileData& data) {
+    const auto per = [](const PhaseStats& phase, size_t event) {
+        const double value = static_cast<double>(phase.counters.values[event]);
+        return phase.rows ? value / static_cast<double>(phase.rows) : value;
+    };
+
+    out << std::endl << std::left << std::setw(24) << "Phase"
+        << std::right << std::setw(16) << "Cycles"
+        << std::setw(16) << "Instructions"
+        << std::setw(8) << "IPC"
+        << std::setw(16) << "LLC miss/row"
+        << std::setw(16) << "Branch miss/row"
+        << std::setw(16) << "Vector instr" << std::endl;
+    bool partial = false;
+    for (const auto& phase : data.phases) {
+        const PerfCounters::Sample& counters = phase.counters;
+        if (!counters.available[PerfCounters::Cycles]) {
+            continue;
+        }
+
+        partial = partial || counters.workerTasks > 0;
+        out << std::left << std::setw(24) << (counters.workerTasks > 0 ? phase.name + " *" : phase.name) << std::right << std::fixed
+            << std::setprecision(0) << std::setw(16) << static_cast<double>(counters.values[PerfCounters::Cycles])
+            << std::setw(16) << static_cast<double>(counters.values[PerfCounters::Instructions])
+            << std::setprecision(2) << std::setw(8)
+            << (counters.values[PerfCounters::Cycles] ? static_cast<double>(counters.values[PerfCounters::Instructions]) / static_cast<double>(counters.values[PerfCounters::Cycles]) : 0.0)
+            << std::setprecision(3);
+        for (size_t event : { PerfCounters::CacheMisses, PerfCounters::BranchMisses }) {
+            out << std::setw(16);
+            if (counters.available[event]) {
+                out << per(phase, event);
+            }
+            else {
+                out << "-";
+            }
+        }
+        out << std::setw(16);
+        if (counters.available[PerfCounters::VectorInstructions]) {
+            out << std::setprecision(0) << static_cast<double>(counters.values[PerfCounters::VectorInstructions]);
+        }
+        else {
+            out << "-";
+        }
+        out << std::endl;
+    }
+    if (partial) {
+        out << "* Worker threads ran tasks during the phase: only the thread running it is counted." << std::endl;
+    }
+}
+
+// Function to print the allocations of every phase, with the bytes allocated per byte read from the input files,
+// and the peak resident set size of the whole process at the end of the phase. The kernel only keeps this high-water
+// mark for the process, so it includes every earlier phase and never decreases: it bounds the phase from above.
+void printMemorySummary(std::ostream& out, const ProfileData& data) {
+    const double* bytesRead = findCounter(data, "bytes_read");
+
+    out << std::endl << std::left << std::setw(24) << "Phase"
+        << std::right << std::setw(14) << "Allocations"
+        << std::setw(16) << "Allocated (MB)"
+        << std::setw(16) << "Alloc/input B"
+        << std::setw(22) << "Process peak RSS (MB)" << std::endl;
+    for (const auto& phase : data.phases) {
+        const double allocated = static_cast<double>(phase.memory.bytes);
+        out << std::left << std::setw(24) << phase.name << std::right << std::fixed
+            << std::setw(14) << phase.memory.allocations
+            << std::setprecision(3) << std::setw(16) << allocated * 1e-6
+            << std::setw(16);
+        if (bytesRead && *bytesRead > 0.0) {
+            out << allocated / *bytesRead;
+        }
+        else {
+            out << "-";
+        }
+        out << std::setw(22) << static_cast<double>(phase.processPeakBytes) * 1e-6 << std::endl;
+    }
+}
+
+// Function to report the profile at exit, on the error output or to the JSON file given on the command line.
+void reportAtExit() {
+    ProfileData& data = profileData();
+
+    if (data.jsonPath.empty()) {
+        Profiler::PrintSummary(std::cerr);
+        return;
+    }
+
+    std::ofstream file(data.jsonPath);
+    if (!file.is_open()) {
+        std::cerr << "Error: Unable to open the file " << data.jsonPath << " for writing." << std::endl;
+        return;
+    }
+    Profiler::WriteJson(file);
+}
+
+} // namespace
+
+void Profiler::Enable() {
+    ProfileData& data = profileData();
+    std::lock_guard<std::mutex> lock(data.mutex);
+
+    if (!Enabled()) {
+        data.start = Clock::now();
+        enabled = true;
+    }
+}
+
+void Profiler::Setup(const CommandLine& commandLine) {
+    Tracer::Setup(commandLine);
+
+    if (!commandLine.has("profile") && !commandLine.has("perf") && !commandLine.has("memory")) {
+        return;
+    }
+    if (commandLine.has("perf")) {
+        PerfCounters::Enable();
+    }
+    if (commandLine.has("memory")) {
+        MemoryProfiler::Enable();
+    }
+
+    profileData().jsonPath = commandLine.get("profile");
+    Enable();
+    std::atexit(reportAtExit);
+}
+
+void Profiler::RecordPhase(const std::string& name, double seconds, size_t rows, const PerfCounters::Sample& counters,
+    const MemoryProfiler::Sample& memory) {
+    const uint64_t processPeakBytes = MemoryProfiler::Enabled() ? MemoryProfiler::ProcessPeakResidentBytes() : 0;
+    ProfileData& data = profileData();
+    std::lock_guard<std::mutex> lock(data.mutex);
+
+    auto it = data.phasesIndex.find(name);
+    if (it == data.phasesIndex.end()) {
+        it = data.phasesIndex.emplace(name, data.phases.size()).first;
+        data.phases.push_back({ name, 0, 0.0, seconds, seconds, 0, {}, {}, 0 });
+    }
+
+    PhaseStats& stats = data.phases[it->second];
+    stats.calls++;
+    stats.seconds += seconds;
+    stats.minSeconds = std::min(stats.minSeconds, seconds);
+    stats.maxSeconds = std::max(stats.maxSeconds, seconds);
+    stats.rows += rows;
+    for (size_t i = 0; i < PerfCounters::EventsCount; ++i) {
+        if (counters.available[i]) {
+            stats.counters.available[i] = true;
+            stats.counters.values[i] += counters.values[i];
+        }
+    }
+    stats.counters.workerTasks += counters.workerTasks;
+    stats.memory.allocations += memory.allocations;
+    stats.memory.deallocations += memory.deallocations;
+    stats.memory.bytes += memory.bytes;
+    stats.processPeakBytes = std::max(stats.processPeakBytes, processPeakBytes);
+}
+
+void Profiler::AddCounter(const std::string& name, double value) {
+    if (!Enabled()) {
+        return;
+    }
+
+    ProfileData& data = profileData();
+    std::lock_guard<std::mutex> lock(data.mutex);
+
+    for (auto& counter : data.counters) {
+        if (counter.first == name) {
+            counter.second += value;
+            return;
+        }
+    }
+    data.counters.emplace_back(name, value);
+}
+
+void Profiler::PrintSummary(std::ostream& out) {
+    ProfileData& data = profileData();
+    std::lock_guard<std::mutex> lock(data.mutex);
+
+    const double wall = wallSeconds(data);
+    const auto flags = out.flags();
+
+    out << std::endl << std::left << std::setw(24) << "Phase"
+        << std::right << std::setw(10) << "Calls"
+        << std::setw(14) << "Total (s)"
+        << std::setw(14) << "Mean (ms)"
+        << std::setw(14) << "Max (ms)"
+        << std::setw(10) << "Wall %" << std::endl;
+    for (const auto& phase : data.phases) {
+        out << std::left << std::setw(24) << phase.name
+            << std::right << std::setw(10) << phase.calls
+            << std::fixed << std::setprecision(6) << std::setw(14) << phase.seconds
+            << std::setprecision(3) << std::setw(14) << 1e3 * phase.seconds / static_cast<double>(phase.calls)
+            << std::setw(14) << 1e3 * phase.maxSeconds
+            << std::setprecision(1) << std::setw(10) << 100.0 * phase.seconds / wall << std::endl;
+    }
+    out << std::left << std::setw(24) << "wall" << std::right << std::setw(24) << std::setprecision(6) << wall << std::endl;
+
+    if (!data.counters.empty()) {
+        out << std::endl << std::left << std::setw(24) << "Counter" << std::right << std::setw(24) << "Value" << std::endl;
+        for (const auto& counter : data.counters) {
+            out << std::left << std::setw(24) << counter.first
+                << std::right << std::setw(24) << std::setprecision(0) << counter.second << std::endl;
+        }
+    }
+
+    for (const auto& rate : DerivedRates) {
+        const PhaseStats* phase = findPhase(data, rate.phase);
+        const double* counter = findCounter(data, rate.counter);
+        if (phase && counter && phase->seconds > 0.0) {
+            out << std::left << std::setw(24) << rate.name
+                << std::right << std::setw(24) << std::setprecision(3) << *counter / phase->seconds * rate.scale << std::endl;
+        }
+    }
+
+    if (PerfCounters::Enabled()) {
+        printCountersSummary(out, data);
+    }
+    if (MemoryProfiler::Enabled()) {
+        printMemorySummary(out, data);
+    }
+
+    out.flags(flags);
+}
+
+void Profiler::WriteJson(std::ostream& out) {
+    ProfileData& data = profileData();
+    std::lock_guard<std::mutex> lock(data.mutex);
+
+    out << std::setprecision(9);
+    out << "{\n  \"wall_seconds\": " << wallSeconds(data) << ",\n  \"phases\": [";
+    for (size_t i = 0; i < data.phases.size(); ++i) {
+        const auto& phase = data.phases[i];
+        out << (i ? "," : "") << "\n    {\"name\": \"" << phase.name << "\", "
+            << "\"calls\": " << phase.calls << ", "
+            << "\"seconds\": " << phase.seconds << ", "
+            << "\"min_seconds\": " << phase.minSeconds << ", "
+            << "\"max_seconds\": " << phase.maxSeconds << ", "
+            << "\"rows\": " << phase.rows;
+        for (size_t event = 0; event < PerfCounters::EventsCount; ++event) {
+            if (phase.counters.available[event]) {
+                out << ", \"" << PerfCounters::EventName(event) << "\": " << phase.counters.values[event];
+            }
+        }
+        if (phase.counters.available[PerfCounters::Cycles]) {
+            // The counts miss the events of the worker threads when they ran tasks during the phase
+            out << ", \"counters_calling_thread_only\": " << (phase.counters.workerTasks > 0 ? "true" : "false");
+        }
+        if (MemoryProfiler::Enabled()) {
+            out << ", \"allocations\": " << phase.memory.allocations
+                << ", \"deallocations\": " << phase.memory.deallocations
+                << ", \"allocated_bytes\": " << phase.memory.bytes
+                << ", \"process_peak_resident_bytes\": " << phase.processPeakBytes;
+        }
+        out << "}";
+    }
+    out << "\n  ],\n  \"counters\": {";
+    for (size_t i = 0; i < data.counters.size(); ++i) {
+        out << (i ? "," : "") << "\n    \"" << data.counters[i].first << "\": " << data.counters[i].second;
+    }
+    out << "\n  }\n}" << std::endl;
+}
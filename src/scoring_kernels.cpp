@@ -0,0 +1,169 @@
+#include "scoring_kernels.h"
+#include <array>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+namespace {
+
+// Function to return the weighted sum of the inputs, unrolled at compile time when D is known.
+// The products are added in order, as by the generic kernels, so that both give the same results.
+template <size_t D, size_t... I>
+inline double weightedSum(const double* weights, const double* inputs, std::index_sequence<I...>) {
+    double sum = 0.0;
+    ((sum += weights[I] * inputs[I]), ...);
+    return sum;
+}
+
+inline double sigmoid(double weightedSum) {
+    return 1.0 / (1.0 + std::exp(-weightedSum));
+}
+
+// Kernels specialized on D features and K houses.
+template <size_t D, size_t K>
+struct Specialized {
+    static double hypothesis(const double* weights, const double* inputs, size_t) {
+        return sigmoid(weightedSum<D>(weights, inputs, std::make_index_sequence<D>()));
+    }
+
+    static void gradient(const std::vector<std::vector<double>>& inputs, const std::vector<std::vector<double>>& targets,
+        size_t house, const double* weights, size_t, double* gradient) {
+        double w[D];
+        double sums[D] = {};
+        for (size_t j = 0; j < D; ++j) {
+            w[j] = weights[j];
+        }
+        for (size_t i = 0; i < inputs.size(); ++i) {
+            const double* x = inputs[i].data();
+            const double error = hypothesis(w, x, D) - targets[i][house];
+            for (size_t j = 0; j < D; ++j) {
+                sums[j] += error * x[j];
+            }
+        }
+        for (size_t j = 0; j < D; ++j) {
+            gradient[j] = (1.0 / static_cast<double>(inputs.size())) * sums[j];
+        }
+    }
+
+    static double logLikelihood(const std::vector<std::vector<double>>& inputs, const std::vector<std::vector<double>>& targets,
+        size_t house, const double* weights, size_t) {
+        double w[D];
+        for (size_t j = 0; j < D; ++j) {
+            w[j] = weights[j];
+        }
+        double sum = 0.0;
+        for (size_t i = 0; i < inputs.size(); ++i) {
+            const double probability = hypothesis(w, inputs[i].data(), D);
+            const double target = targets[i][house];
+            sum += target * std::log(probability + 1e-15) + (1.0 - target) * std::log(1.0 - probability + 1e-15);
+        }
+        return sum;
+    }
+
+    static void predict(const std::vector<std::vector<double>>& inputs, size_t begin, size_t end, const double* weights,
+        size_t, size_t, size_t* houses) {
+        double w[K * D];
+        for (size_t j = 0; j < K * D; ++j) {
+            w[j] = weights[j];
+        }
+        for (size_t i = begin; i < end; ++i) {
+            const double* x = inputs[i].data();
+            double maxSum = -std::numeric_limits<double>::infinity();
+            size_t predictedHouse = 0;
+            for (size_t house = 0; house < K; ++house) {
+                const double sum = weightedSum<D>(w + house * D, x, std::make_index_sequence<D>());
+                if (sum > maxSum) {
+                    maxSum = sum;
+                    predictedHouse = house;
+                }
+            }
+            houses[i - begin] = predictedHouse;
+        }
+    }
+};
+
+// Kernels of any feature and house counts.
+struct Generic {
+    static double hypothesis(const double* weights, const double* inputs, size_t features) {
+        double sum = 0.0;
+        for (size_t j = 0; j < features; ++j) {
+            sum += weights[j] * inputs[j];
+        }
+        return sigmoid(sum);
+    }
+
+    static void gradient(const std::vector<std::vector<double>>& inputs, const std::vector<std::vector<double>>& targets,
+        size_t house, const double* weights, size_t features, double* gradient) {
+        std::vector<double> sums(features, 0.0);
+        for (size_t i = 0; i < inputs.size(); ++i) {
+            const double* x = inputs[i].data();
+            const double error = hypothesis(weights, x, features) - targets[i][house];
+            for (size_t j = 0; j < features; ++j) {
+                sums[j] += error * x[j];
+            }
+        }
+        for (size_t j = 0; j < features; ++j) {
+            gradient[j] = (1.0 / static_cast<double>(inputs.size())) * sums[j];
+        }
+    }
+
+    static double logLikelihood(const std::vector<std::vector<double>>& inputs, const std::vector<std::vector<double>>& targets,
+        size_t house, const double* weights, size_t features) {
+        double sum = 0.0;
+        for (size_t i = 0; i < inputs.size(); ++i) {
+            const double probability = hypothesis(weights, inputs[i].data(), features);
+            const double target = targets[i][house];
+            sum += target * std::log(probability + 1e-15) + (1.0 - target) * std::log(1.0 - probability + 1e-15);
+        }
+        return sum;
+    }
+
+    static void predict(const std::vector<std::vector<double>>& inputs, size_t begin, size_t end, const double* weights,
+        size_t features, size_t housesCount, size_t* houses) {
+        for (size_t i = begin; i < end; ++i) {
+            double maxSum = -std::numeric_limits<double>::infinity();
+            size_t predictedHouse = 0;
+            for (size_t house = 0; house < housesCount; ++house) {
+                double sum = 0.0;
+                for (size_t j = 0; j < features; ++j) {
+                    sum += weights[house * features + j] * inputs[i][j];
+                }
+                if (sum > maxSum) {
+                    maxSum = sum;
+                    predictedHouse = house;
+                }
+            }
+            houses[i - begin] = predictedHouse;
+        }
+    }
+};
+
+template <typename Kernels>
+constexpr ScoringKernels::Set makeSet(bool specialized) {
+    return { Kernels::hypothesis, Kernels::gradient, Kernels::logLikelihood, Kernels::predict, specialized };
+}
+
+// Dispatch table indexed by the feature count, entry 0 holding the generic kernels.
+template <size_t... D>
+constexpr std::array<ScoringKernels::Set, sizeof...(D) + 1> makeTable(std::index_sequence<D...>) {
+    return { makeSet<Generic>(false), makeSet<Specialized<D + 1, ScoringKernels::SpecializedHouses>>(true)... };
+}
+
+constexpr auto SpecializedKernels = makeTable(std::make_index_sequence<ScoringKernels::MaxSpecializedFeatures>());
+
+} // namespace
+
+const ScoringKernels::Set& ScoringKernels::Select(size_t features, size_t housesCount) {
+    if (features == 0 || features > MaxSpecializedFeatures || housesCount != SpecializedHouses) {
+        return SpecializedKernels[0];
+    }
+    return SpecializedKernels[features];
+}
+
+std::vector<double> ScoringKernels::Flatten(const std::vector<std::vector<double>>& weights) {
+    std::vector<double> flat;
+    for (const auto& houseWeights : weights) {
+        flat.insert(flat.end(), houseWeights.begin(), houseWeights.end());
+    }
+    return flat;
+}
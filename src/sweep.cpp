@@ -0,0 +1,126 @@
+#include "sweep.h"
+#include "thread_pool.h"
+#include "tracer.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <random>
+#include <stdexcept>
+
+namespace {
+
+// Function to draw a value log-uniformly between the smallest and largest positive values of a list
+double drawLogUniform(const std::vector<double>& values, std::mt19937_64& generator) {
+    double low = 0.0, high = 0.0;
+    for (double value : values) {
+        if (value > 0.0) {
+            low = low == 0.0 ? value : std::min(low, value);
+            high = std::max(high, value);
+        }
+    }
+    if (high == 0.0) {
+        return 0.0;
+    }
+    std::uniform_real_distribution<double> distribution(std::log(low), std::log(high));
+    return std::exp(distribution(generator));
+}
+
+} // namespace
+
+std::vector<TrainingSettings> Sweep::Grid(const SweepSpace& space) {
+    std::vector<TrainingSettings> grid;
+    for (Solver solver : space.solvers) {
+        for (double learningRate : space.learningRates) {
+            for (size_t epochs : space.epochs) {
+                for (double l2 : space.l2) {
+                    TrainingSettings settings;
+                    settings.learningRate = learningRate;
+                    settings.epochs = epochs;
+                    settings.l2 = l2;
+                    settings.solver = solver;
+                    grid.push_back(settings);
+                }
+            }
+        }
+    }
+    return grid;
+}
+
+std::vector<TrainingSettings> Sweep::Sample(const SweepSpace& space, size_t trials, uint64_t seed) {
+    if (space.learningRates.empty() || space.epochs.empty() || space.l2.empty() || space.solvers.empty()) {
+        throw std::runtime_error("Error: Every hyperparameter of a sweep needs at least one value.");
+    }
+
+    std::mt19937_64 generator(seed);
+    const auto [minEpochs, maxEpochs] = std::minmax_element(space.epochs.begin(), space.epochs.end());
+    std::uniform_int_distribution<size_t> epochs(*minEpochs, *maxEpochs);
+    std::uniform_int_distribution<size_t> solver(0, space.solvers.size() - 1);
+    std::uniform_int_distribution<size_t> l2Value(0, space.l2.size() - 1);
+    const bool unpenalized = std::find(space.l2.begin(), space.l2.end(), 0.0) != space.l2.end();
+
+    std::vector<TrainingSettings> samples(trials);
+    for (auto& settings : samples) {
+        settings.learningRate = drawLogUniform(space.learningRates, generator);
+        settings.epochs = epochs(generator);
+        settings.l2 = unpenalized && space.l2[l2Value(generator)] == 0.0 ? 0.0 : drawLogUniform(space.l2, generator);
+        settings.solver = space.solvers[solver(generator)];
+    }
+    return samples;
+}
+
+std::vector<SweepTrial> Sweep::Run(const DesignMatrix& matrix, const std::vector<TrainingSettings>& settings,
+    size_t holdoutFolds, uint64_t seed, size_t threadsCount) {
+    if (holdoutFolds < 2 || holdoutFolds > matrix.rows) {
+        throw std::runtime_error("Error: The number of folds must be between 2 and the number of students.");
+    }
+
+    // One preprocessing for every trial, only read by them
+    const FoldView fold = CrossValidation::Fold(matrix, 0, holdoutFolds);
+    const FoldScaling scaling = CrossValidation::FitScaling(fold);
+
+    std::vector<SweepTrial> trials(settings.size());
+    {
+        ThreadPool pool(threadsCount);
+        for (size_t i = 0; i < settings.size(); ++i) {
+            pool.Submit([&, i] {
+                Tracer::Scope scope("sweep.trial");
+                const auto start = std::chrono::steady_clock::now();
+                trials[i].settings = settings[i];
+                trials[i].result = CrossValidation::TrainFold(fold, scaling, settings[i], seed);
+                trials[i].seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            });
+        }
+        pool.Wait();
+    }
+
+    // Diverged trials have a NaN log-loss and go last
+    std::stable_sort(trials.begin(), trials.end(), [](const SweepTrial& a, const SweepTrial& b) {
+        return std::isnan(b.result.logLoss) ? !std::isnan(a.result.logLoss) : a.result.logLoss < b.result.logLoss;
+    });
+    return trials;
+}
+
+void Sweep::WriteLeaderboard(const std::vector<SweepTrial>& trials, std::ostream& out) {
+    // JSON has no NaN, so the scores of diverged trials are null
+    auto number = [&](double value) -> std::ostream& {
+        return std::isfinite(value) ? out << value : out << "null";
+    };
+
+    out << std::setprecision(9);
+    out << "{\n  \"trials\": [";
+    for (size_t i = 0; i < trials.size(); ++i) {
+        const SweepTrial& trial = trials[i];
+        out << (i ? "," : "") << "\n    {\"rank\": " << i + 1 << ", "
+            << "\"learning_rate\": " << trial.settings.learningRate << ", "
+            << "\"epochs\": " << trial.settings.epochs << ", "
+            << "\"l2\": " << trial.settings.l2 << ", "
+            << "\"solver\": \"" << TrainingSettings::SolverName(trial.settings.solver) << "\", "
+            << "\"training_rows\": " << trial.result.trainingRows << ", "
+            << "\"validation_rows\": " << trial.result.validationRows << ", "
+            << "\"accuracy\": ";
+        number(trial.result.accuracy) << ", \"log_loss\": ";
+        number(trial.result.logLoss) << ", \"seconds\": " << trial.seconds << "}";
+    }
+    out << "\n  ]\n}" << std::endl;
+}
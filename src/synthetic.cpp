@@ -0,0 +1,240 @@
+#include "synthetic.h"
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+
+const std::vector<std::string> HouseNames = { "Ravenclaw", "Slytherin", "Gryffindor", "Hufflepuff" };
+
+const std::vector<std::string> CourseNames = { "Arithmancy", "Astronomy", "Herbology", "Defense Against the Dark Arts",
+    "Divination", "Muggle Studies", "Ancient Runes", "History of Magic", "Transfiguration", "Potions",
+    "Care of Magical Creatures", "Charms", "Flying" };
+
+const std::vector<std::string> FirstNames = { "Tamara", "Erich", "Stephany", "Vesta", "Gaston", "Hartley",
+    "Marvin", "Nedra", "Pauline", "Caitlin", "Alfredo", "Kurt", "Zora", "Tyree", "Ashlee", "Elvira" };
+
+// Distribution of the scores of a course: every house is offset from the course mean by a multiple of its noise.
+struct CourseModel {
+    double mean;
+    double scale;
+    double offsets[4];
+};
+
+// Function to mix a 64-bit value into a well distributed seed.
+uint64_t splitMix64(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+// Function to draw the course models of a dataset. One course in four is homogeneous between the houses.
+std::vector<CourseModel> courseModels(const SyntheticOptions& options) {
+    std::mt19937_64 gen(splitMix64(options.seed));
+    std::uniform_real_distribution<double> meanDistribution(-500.0, 1000.0);
+    std::uniform_real_distribution<double> logScaleDistribution(0.0, 3.0);
+    std::normal_distribution<double> offsetDistribution(0.0, 1.0);
+
+    std::vector<CourseModel> models(options.features);
+    for (size_t j = 0; j < options.features; ++j) {
+        models[j].mean = meanDistribution(gen);
+        models[j].scale = std::pow(10.0, logScaleDistribution(gen));
+        for (size_t h = 0; h < HouseNames.size(); ++h) {
+            const double offset = options.separation * offsetDistribution(gen);
+            models[j].offsets[h] = j % 4 == 3 ? 0.0 : offset;
+        }
+    }
+    return models;
+}
+
+// Function to generate the rows of a block, calling visit(row, house, features) for each of them.
+template <typename Visitor>
+void generateBlock(const SyntheticOptions& options, const std::vector<CourseModel>& models, size_t block, Visitor visit) {
+    std::mt19937_64 gen(splitMix64(options.seed ^ splitMix64(block + 1)));
+    std::uniform_int_distribution<size_t> houseDistribution(0, HouseNames.size() - 1);
+    std::normal_distribution<double> noise(0.0, 1.0);
+    std::uniform_real_distribution<double> missing(0.0, 1.0);
+
+    const size_t begin = block * Synthetic::BlockRows;
+    const size_t end = std::min(options.rows, begin + Synthetic::BlockRows);
+    std::vector<double> features(options.features);
+
+    for (size_t row = begin; row < end; ++row) {
+        const size_t house = houseDistribution(gen);
+        for (size_t j = 0; j < options.features; ++j) {
+            const double value = models[j].mean + models[j].scale * (models[j].offsets[house] + noise(gen));
+            features[j] = missing(gen) < options.nanRate ? std::numeric_limits<double>::quiet_NaN() : value;
+        }
+        visit(row, house, features);
+    }
+}
+
+// Function to build the labels of a row: house, first name, last name, birthday and best hand.
+std::vector<std::string> rowLabels(const SyntheticOptions& options, size_t row, size_t house) {
+    const uint64_t hash = splitMix64(options.seed + row);
+    const std::string month = std::to_string(1 + hash % 12);
+    const std::string day = std::to_string(1 + (hash >> 8) % 28);
+
+    return {
+        options.testSet ? "" : HouseNames[house],
+        FirstNames[(hash >> 16) % FirstNames.size()],
+        "Student" + std::to_string(row),
+        std::to_string(1995 + (hash >> 24) % 10) + "-" + (month.size() < 2 ? "0" : "") + month + "-" + (day.size() < 2 ? "0" : "") + day,
+        (hash >> 32) % 2 ? "Left" : "Right"
+    };
+}
+
+// Function to format the rows of a block as CSV lines.
+void formatCsvBlock(const SyntheticOptions& options, const std::vector<CourseModel>& models, size_t block, std::string& out) {
+    char buffer[64];
+
+    generateBlock(options, models, block, [&](size_t row, size_t house, const std::vector<double>& features) {
+        out += std::to_string(row);
+        for (const auto& label : rowLabels(options, row, house)) {
+            out += ',';
+            out += label;
+        }
+        for (double feature : features) {
+            out += ',';
+            if (!std::isnan(feature)) {
+                auto result = std::to_chars(buffer, buffer + sizeof(buffer), feature, std::chars_format::fixed, 6);
+                out.append(buffer, result.ptr);
+            }
+        }
+        out += '\n';
+    });
+}
+
+// Function to append the raw bytes of a value to a binary buffer.
+template <typename T>
+void appendRaw(std::string& out, const T& value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+// Function to append a length-prefixed string to a binary buffer.
+void appendString(std::string& out, const std::string& value) {
+    appendRaw(out, static_cast<uint32_t>(value.size()));
+    out += value;
+}
+
+// Function to format the rows of a block in the binary cache layout.
+void formatBinaryBlock(const SyntheticOptions& options, const std::vector<CourseModel>& models, size_t block, std::string& out) {
+    generateBlock(options, models, block, [&](size_t row, size_t house, const std::vector<double>& features) {
+        appendRaw(out, static_cast<uint64_t>(row));
+        for (const auto& label : rowLabels(options, row, house)) {
+            appendString(out, label);
+        }
+        out.append(reinterpret_cast<const char*>(features.data()), features.size() * sizeof(double));
+    });
+}
+
+// Function to write the blocks of a dataset in order. Batches of blocks are formatted in parallel
+// while a writer thread flushes the previous batch.
+template <typename Formatter>
+void writeBlocks(std::ofstream& file, const SyntheticOptions& options, Formatter format) {
+    const std::vector<CourseModel> models = courseModels(options);
+    const size_t blocksCount = (options.rows + Synthetic::BlockRows - 1) / Synthetic::BlockRows;
+    const size_t batchBlocks = 4 * static_cast<size_t>(std::max(1u, std::thread::hardware_concurrency()));
+
+    std::vector<std::string> pending;
+    std::thread writer;
+
+    for (size_t batchStart = 0; batchStart < blocksCount; batchStart += batchBlocks) {
+        std::vector<std::string> batch(std::min(batchBlocks, blocksCount - batchStart));
+        Utils::ParallelFor(batch.size(), [&](size_t i) {
+            format(options, models, batchStart + i, batch[i]);
+        });
+
+        if (writer.joinable()) {
+            writer.join();
+        }
+        pending = std::move(batch);
+        writer = std::thread([&file, &pending]() {
+            Tracer::SetThreadName("writer");
+            Tracer::Scope scope("write.batch");
+            for (const auto& block : pending) {
+                file.write(block.data(), static_cast<std::streamsize>(block.size()));
+            }
+        });
+    }
+
+    if (writer.joinable()) {
+        writer.join();
+    }
+}
+
+} // namespace
+
+std::vector<std::string> Synthetic::Headers(const SyntheticOptions& options) {
+    std::vector<std::string> headers = { "Index", "Hogwarts House", "First Name", "Last Name", "Birthday", "Best Hand" };
+    for (size_t j = 0; j < options.features; ++j) {
+        headers.push_back(j < CourseNames.size() ? CourseNames[j] : "Course " + std::to_string(j + 1));
+    }
+    return headers;
+}
+
+void Synthetic::GenerateStudents(const SyntheticOptions& options, size_t begin, size_t end, std::vector<StudentInfo>& students) {
+    const std::vector<CourseModel> models = courseModels(options);
+    end = std::min(end, options.rows);
+
+    for (size_t block = begin / BlockRows; block * BlockRows < end; ++block) {
+        generateBlock(options, models, block, [&](size_t row, size_t house, const std::vector<double>& features) {
+            if (row < begin || row >= end) {
+                return;
+            }
+            StudentInfo student;
+            student.index = row;
+            student.labels = rowLabels(options, row, house);
+            student.features = features;
+            students.push_back(std::move(student));
+        });
+    }
+}
+
+void Synthetic::WriteCsv(const std::string& filename, const SyntheticOptions& options) {
+    std::ofstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("Error: Unable to open the file " + filename + " for writing.");
+    }
+
+    const std::vector<std::string> headers = Headers(options);
+    for (size_t i = 0; i < headers.size(); ++i) {
+        file << (i ? "," : "") << headers[i];
+    }
+    file << "\n";
+
+    writeBlocks(file, options, formatCsvBlock);
+
+    if (!file) {
+        throw std::runtime_error("Error: Writing the file " + filename + ".");
+    }
+}
+
+void Synthetic::WriteBinary(const std::string& filename, const SyntheticOptions& options) {
+    std::ofstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("Error: Unable to open the file " + filename + " for writing.");
+    }
+
+    const std::vector<std::string> headers = Headers(options);
+    std::string header(Utils::BinaryCacheMagic, std::strlen(Utils::BinaryCacheMagic));
+    appendRaw(header, static_cast<uint64_t>(options.rows));
+    appendRaw(header, static_cast<uint32_t>(headers.size()));
+    appendRaw(header, static_cast<uint32_t>(headers.size() - options.features));
+    for (const auto& name : headers) {
+        appendString(header, name);
+    }
+    file.write(header.data(), static_cast<std::streamsize>(header.size()));
+
+    writeBlocks(file, options, formatBinaryBlock);
+
+    if (!file) {
+        throw std::runtime_error("Error: Writing the file " + filename + ".");
+    }
+}
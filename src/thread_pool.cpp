@@ -0,0 +1,123 @@
+#include "thread_pool.h"
+#include "tracer.h"
+#include "perf_counters.h"
+#include <algorithm>
+
+namespace {
+
+// Pool and queue of the calling thread when it is a worker.
+thread_local const ThreadPool* currentPool = nullptr;
+thread_local size_t currentWorker = 0;
+
+} // namespace
+
+ThreadPool::ThreadPool(size_t threadsCount) {
+    if (threadsCount == 0) {
+        threadsCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    for (size_t i = 0; i < threadsCount; ++i) {
+        workers.push_back(std::make_unique<Worker>());
+    }
+    // The workers only start once every queue exists, since they steal from all of them
+    for (size_t i = 0; i < threadsCount; ++i) {
+        workers[i]->thread = std::thread(&ThreadPool::run, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait(lock, [this] { return unfinished == 0; });
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& worker : workers) {
+        worker->thread.join();
+    }
+}
+
+void ThreadPool::Submit(std::function<void()> task) {
+    {
+        // The task is counted as queued before a worker can take it, under the same lock
+        std::lock_guard<std::mutex> lock(mutex);
+        const size_t index = currentPool == this ? currentWorker : nextQueue++ % workers.size();
+        {
+            std::lock_guard<std::mutex> queueLock(workers[index]->mutex);
+            workers[index]->tasks.push_back(std::move(task));
+        }
+        queued++;
+        unfinished++;
+    }
+    wake.notify_one();
+}
+
+void ThreadPool::Wait() {
+    std::unique_lock<std::mutex> lock(mutex);
+    done.wait(lock, [this] { return unfinished == 0; });
+    if (error) {
+        std::exception_ptr raised = error;
+        error = nullptr;
+        std::rethrow_exception(raised);
+    }
+}
+
+bool ThreadPool::takeTask(size_t index, std::function<void()>& task) {
+    {
+        Worker& own = *workers[index];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            return true;
+        }
+    }
+    for (size_t offset = 1; offset < workers.size(); ++offset) {
+        Worker& victim = *workers[(index + offset) % workers.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::run(size_t index) {
+    currentPool = this;
+    currentWorker = index;
+    Tracer::SetThreadName("pool.worker");
+
+    std::function<void()> task;
+    while (true) {
+        if (!takeTask(index, task)) {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this] { return queued > 0 || stopping; });
+            if (queued == 0 && stopping) {
+                return;
+            }
+            continue;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            queued--;
+        }
+        PerfCounters::RecordWorkerTask();
+        try {
+            task();
+        }
+        catch (...) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!error) {
+                error = std::current_exception();
+            }
+        }
+        task = nullptr;
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--unfinished == 0) {
+            done.notify_all();
+        }
+    }
+}
@@ -0,0 +1,197 @@
+#include "tracer.h"
+#include "utils.h"
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Begin ('B') or end ('E') of a region, timestamped in nanoseconds since the tracer was enabled.
+struct TraceEvent {
+    const char* name;
+    uint64_t timestamp;
+    char phase;
+};
+
+// Ring buffer of the events of one thread at a time. Only that thread writes to it, so recording an event takes no
+// lock: the event is stored first, then published by incrementing the count. Its chunks are allocated on their first
+// event, in a fixed table so that the events already published never move.
+struct ThreadBuffer {
+    static constexpr size_t ChunksCount = Tracer::EventsPerThread / Tracer::EventsPerChunk;
+
+    uint32_t tid = 0;
+    std::atomic<const char*> name{ nullptr };
+    std::unique_ptr<TraceEvent[]> chunks[ChunksCount];
+    std::atomic<uint64_t> count{ 0 };
+
+    void push(const char* eventName, uint64_t timestamp, char phase) {
+        const uint64_t index = count.load(std::memory_order_relaxed);
+        const size_t slot = static_cast<size_t>(index % Tracer::EventsPerThread);
+        std::unique_ptr<TraceEvent[]>& chunk = chunks[slot / Tracer::EventsPerChunk];
+        if (!chunk) {
+            chunk = std::make_unique<TraceEvent[]>(Tracer::EventsPerChunk);
+        }
+        chunk[slot % Tracer::EventsPerChunk] = { eventName, timestamp, phase };
+        count.store(index + 1, std::memory_order_release);
+    }
+
+    const TraceEvent& operator[](uint64_t index) const {
+        const size_t slot = static_cast<size_t>(index % Tracer::EventsPerThread);
+        return chunks[slot / Tracer::EventsPerChunk][slot % Tracer::EventsPerChunk];
+    }
+};
+
+// Buffers of every thread that recorded an event. They outlive their threads, and the buffers of the finished
+// threads are handed to the next new ones, which continue their events under the same trace thread id.
+struct TraceData {
+    std::mutex mutex;
+    Clock::time_point start;
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+    std::vector<ThreadBuffer*> freeBuffers;
+    std::string path = "trace.json";
+};
+
+TraceData& traceData() {
+    static TraceData data;
+    return data;
+}
+
+// Buffer held by a thread from its first event to its end, when it is given back for reuse.
+struct ThreadBufferLease {
+    ThreadBuffer* buffer;
+
+    ThreadBufferLease() {
+        TraceData& data = traceData();
+        std::lock_guard<std::mutex> lock(data.mutex);
+        if (!data.freeBuffers.empty()) {
+            buffer = data.freeBuffers.back();
+            data.freeBuffers.pop_back();
+            buffer->name.store(nullptr, std::memory_order_relaxed);
+            return;
+        }
+        data.buffers.push_back(std::make_unique<ThreadBuffer>());
+        buffer = data.buffers.back().get();
+        buffer->tid = static_cast<uint32_t>(data.buffers.size());
+    }
+
+    ~ThreadBufferLease() {
+        TraceData& data = traceData();
+        std::lock_guard<std::mutex> lock(data.mutex);
+        data.freeBuffers.push_back(buffer);
+    }
+};
+
+ThreadBuffer& threadBuffer() {
+    thread_local ThreadBufferLease lease;
+    return *lease.buffer;
+}
+
+uint64_t timestamp() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - traceData().start).count());
+}
+
+// Function to write the trace file at exit.
+void writeAtExit() {
+    TraceData& data = traceData();
+    std::ofstream file(data.path);
+    if (!file.is_open()) {
+        std::cerr << "Error: Unable to open the file " << data.path << " for writing." << std::endl;
+        return;
+    }
+    Tracer::WriteJson(file);
+}
+
+} // namespace
+
+void Tracer::Enable() {
+    TraceData& data = traceData();
+    {
+        std::lock_guard<std::mutex> lock(data.mutex);
+        if (Enabled()) {
+            return;
+        }
+        data.start = Clock::now();
+        enabled = true;
+    }
+    SetThreadName("main");
+}
+
+void Tracer::Setup(const CommandLine& commandLine) {
+    if (!commandLine.has("trace")) {
+        return;
+    }
+
+    const std::string path = commandLine.get("trace");
+    if (!path.empty()) {
+        traceData().path = path;
+    }
+    Enable();
+    std::atexit(writeAtExit);
+}
+
+void Tracer::Begin(const char* name) {
+    threadBuffer().push(name, timestamp(), 'B');
+}
+
+void Tracer::End(const char* name) {
+    threadBuffer().push(name, timestamp(), 'E');
+}
+
+void Tracer::SetThreadName(const char* name) {
+    if (Enabled()) {
+        threadBuffer().name.store(name, std::memory_order_relaxed);
+    }
+}
+
+void Tracer::WriteJson(std::ostream& out) {
+    TraceData& data = traceData();
+    std::lock_guard<std::mutex> lock(data.mutex);
+
+    const auto flags = out.flags();
+    out << std::fixed << std::setprecision(3);
+    out << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [";
+
+    bool first = true;
+    auto separator = [&first]() {
+        const char* value = first ? "\n" : ",\n";
+        first = false;
+        return value;
+    };
+
+    for (const auto& buffer : data.buffers) {
+        const char* name = buffer->name.load(std::memory_order_relaxed);
+        out << separator() << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": " << buffer->tid
+            << ", \"args\": {\"name\": \"" << (name ? name : "worker " + std::to_string(buffer->tid)) << "\"}}";
+
+        // Only the last events are kept, so end events whose beginning was overwritten are dropped.
+        const uint64_t count = buffer->count.load(std::memory_order_acquire);
+        const uint64_t begin = count > Tracer::EventsPerThread ? count - Tracer::EventsPerThread : 0;
+        size_t depth = 0;
+        for (uint64_t i = begin; i < count; ++i) {
+            const TraceEvent& event = (*buffer)[i];
+            if (event.phase == 'E') {
+                if (depth == 0) {
+                    continue;
+                }
+                depth--;
+            }
+            else {
+                depth++;
+            }
+            out << separator() << "{\"name\": \"" << event.name << "\", \"ph\": \"" << event.phase
+                << "\", \"ts\": " << static_cast<double>(event.timestamp) * 1e-3
+                << ", \"pid\": 1, \"tid\": " << buffer->tid << "}";
+        }
+    }
+
+    out << "\n]}" << std::endl;
+    out.flags(flags);
+}
@@ -1,5 +1,6 @@
 #include "utils.h"
 #include "calculate.h"
+#include "profiler.h"
 #include <iostream>
 #include <fstream>
 #include <sstream>
@@ -7,9 +8,18 @@
 #include <iomanip>
 #include <limits>
 #include <stdexcept>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <tuple>
+#include <charconv>
+#include <numeric>
+#ifndef _MSC_VER
+#include <glob.h>
+#endif // MVS
 
 // Function to check if a string represents a number, allowing for negative numbers and decimal points.
-bool Utils::isNumber(const std::string& str) {
+bool Utils::isNumber(std::string_view str) {
     bool hasDigit = false;
     bool hasDot = false;
 
@@ -34,6 +44,110 @@ bool Utils::isNumber(const std::string& str) {
     return hasDigit || hasDot;
 }
 
+bool Utils::ParseCount(std::string_view text, uint64_t max, uint64_t& value) {
+    uint64_t parsed = 0;
+    const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), parsed);
+    if (text.empty() || error != std::errc() || end != text.data() + text.size() || parsed > max) {
+        return false;
+    }
+    value = parsed;
+    return true;
+}
+
+bool CommandLine::has(const std::string& name) const {
+    return options.count(name) != 0;
+}
+
+std::string CommandLine::get(const std::string& name, const std::string& fallback) const {
+    auto it = options.find(name);
+    return it == options.end() ? fallback : it->second;
+}
+
+double CommandLine::getNumber(const std::string& name, double fallback) const {
+    auto it = options.find(name);
+    if (it == options.end()) {
+        return fallback;
+    }
+    try {
+        return std::stod(it->second);
+    }
+    catch (const std::exception&) {
+        throw std::runtime_error("Error: Wrong value for option --" + name + " : " + it->second);
+    }
+}
+
+uint64_t CommandLine::getCount(const std::string& name, uint64_t fallback, uint64_t max) const {
+    auto it = options.find(name);
+    if (it == options.end()) {
+        return fallback;
+    }
+    uint64_t value = 0;
+    if (!Utils::ParseCount(it->second, max, value)) {
+        const std::string bound = max == std::numeric_limits<uint64_t>::max() ? "" : " up to " + std::to_string(max);
+        throw std::runtime_error("Error: Wrong value for option --" + name + " : " + it->second + " (a whole number" + bound + " is expected)");
+    }
+    return value;
+}
+
+std::vector<std::string> CommandLine::getList(const std::string& name, const std::vector<std::string>& fallback) const {
+    auto it = options.find(name);
+    if (it == options.end()) {
+        return fallback;
+    }
+    std::vector<std::string> values;
+    std::istringstream stream(it->second);
+    for (std::string value; std::getline(stream, value, ',');) {
+        values.push_back(value);
+    }
+    if (values.empty()) {
+        throw std::runtime_error("Error: Missing values for option --" + name);
+    }
+    return values;
+}
+
+std::vector<double> CommandLine::getNumbers(const std::string& name, const std::vector<double>& fallback) const {
+    if (!has(name)) {
+        return fallback;
+    }
+    std::vector<double> values;
+    for (const std::string& value : getList(name, {})) {
+        try {
+            values.push_back(std::stod(value));
+        }
+        catch (const std::exception&) {
+            throw std::runtime_error("Error: Wrong value for option --" + name + " : " + value);
+        }
+    }
+    return values;
+}
+
+// Function to split the command line into positional arguments and options.
+CommandLine Utils::ParseCommandLine(int argc, char* argv[], const std::vector<std::string>& valueOptions) {
+    CommandLine commandLine;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string argument = argv[i];
+        if (argument.rfind("--", 0) != 0 || argument.size() == 2) {
+            commandLine.positional.push_back(argument);
+            continue;
+        }
+
+        const size_t equal = argument.find('=');
+        const std::string name = argument.substr(2, equal == std::string::npos ? std::string::npos : equal - 2);
+        if (equal != std::string::npos) {
+            commandLine.options[name] = argument.substr(equal + 1);
+        }
+        else if (i + 1 < argc && std::find(valueOptions.begin(), valueOptions.end(), name) != valueOptions.end()) {
+            commandLine.options[name] = argv[++i];
+        }
+        else {
+            commandLine.options[name] = "";
+        }
+    }
+
+    return commandLine;
+}
+
 // Function to load headers from the first line of a file.
 void loadHeader(std::ifstream& file, std::vector<std::string>& headers) {
     std::string header;
@@ -48,39 +162,40 @@ void loadHeader(std::ifstream& file, std::vector<std::string>& headers) {
     }
 }
 
-// Function to determine the starting index of features in each data line.
+// Function to determine the starting index of features in each data line. A column holding a number is a feature,
+// one holding another non-empty value is a label; the scan stops once every column is decided, and after
+// `maxLines` lines the columns still empty count as labels, so that it does not read the whole file.
 void determineFeaturesStartIndex(std::ifstream& file, size_t headersCount, size_t& featuresStartIndex) {
-    std::vector<std::string> tempElementsLine(headersCount, "");
+    constexpr size_t maxLines = 1000;
+    enum class Kind : unsigned char { Unknown, Label, Feature };
+    std::vector<Kind> kinds(headersCount, Kind::Unknown);
+    size_t undecided = headersCount > 1 ? headersCount - 1 : 0;
 
-    size_t linesCount = 0;
     std::string line;
 
-    // Iterating through lines to find the first non-empty numeric element in each column.
-    while (std::getline(file, line)) {
-        if (linesCount++ > 10000) {
-            throw std::runtime_error("Error: Wrong file size");
-        }
-
-        std::istringstream lineStream(line);
-
-        size_t currentIndex = 0;
-        std::string element;
-
-        while (std::getline(lineStream, element, ',')) {
-            if (tempElementsLine[currentIndex].empty() && Utils::isNumber(element)) {
-                tempElementsLine[currentIndex] = element;
+    // Iterating through lines until the kind of every column but the index is known.
+    for (size_t lines = 0; undecided > 0 && lines < maxLines && std::getline(file, line); ++lines) {
+        size_t start = 0;
+        for (size_t column = 0; start <= line.size(); ++column) {
+            if (column > 100) {
+                throw std::runtime_error("Error: Wrong header");
             }
+            const size_t end = std::min(line.find(',', start), line.size());
+            const std::string_view element(line.data() + start, end - start);
+            start = end + 1;
 
-            if (currentIndex++ > 100) {
-                throw std::runtime_error("Error: Wrong header");
+            if (column == 0 || column >= headersCount || element.empty() || kinds[column] != Kind::Unknown) {
+                continue;
             }
+            kinds[column] = Utils::isNumber(element) ? Kind::Feature : Kind::Label;
+            undecided--;
         }
     }
 
-    // Setting the featuresStartIndex based on the first non-empty numeric element in each column.
+    // Setting the featuresStartIndex based on the columns holding no number.
     featuresStartIndex = 1;
     for (size_t i = 1; i < headersCount; ++i) {
-        if (tempElementsLine[i].empty()) {
+        if (kinds[i] != Kind::Feature) {
             featuresStartIndex++;
         }
     }
@@ -88,56 +203,233 @@ void determineFeaturesStartIndex(std::ifstream& file, size_t headersCount, size_
 
 
 
-// Function to load data lines from the file and construct StudentInfo objects.
-void loadDataLines(std::ifstream& file, std::vector<StudentInfo>& students, size_t headersCount, size_t featuresStartIndex) {
-    std::string line;
-    std::getline(file, line);
+// Function to parse and validate the index, labels, and features of a data line.
+StudentInfo parseDataLine(const std::string& line, size_t headersCount, size_t featuresStartIndex) {
+    StudentInfo student;
 
-    // Iterating through lines to parse and validate index, labels, and features.
-    while (std::getline(file, line)) {
-        StudentInfo student;
+    std::istringstream lineStream(line);
+    std::string element;
 
-        std::istringstream lineStream(line);
-        std::string element;
+    std::getline(lineStream, element, ',');
+    if (!Utils::isNumber(element)) {
+        throw std::runtime_error("Error: Wrong index in file : " + element + " at index " + std::to_string(student.index));
+    }
+    student.index = static_cast<size_t>(std::stoi(element));
 
+    // Parsing labels for the student.
+    for (size_t i = 1; i < featuresStartIndex; ++i) {
         std::getline(lineStream, element, ',');
-        if (!Utils::isNumber(element)) {
-            throw std::runtime_error("Error: Wrong index in file : " + element + " at index " + std::to_string(student.index));
+        if (element.empty() || !Utils::isNumber(element)) {
+            student.labels.push_back(element);
         }
-        student.index = static_cast<size_t>(std::stoi(element));
+        else {
+            throw std::runtime_error("Error: Wrong label in file : " + element + " at index " + std::to_string(student.index));
+        }
+    }
 
-        // Parsing labels for the student.
-        for (size_t i = 1; i < featuresStartIndex; ++i) {
-            std::getline(lineStream, element, ',');
-            if (element.empty() || !Utils::isNumber(element)) {
-                student.labels.push_back(element);
-            }
-            else {
-                throw std::runtime_error("Error: Wrong label in file : " + element + " at index " + std::to_string(student.index));
-            }
+    // Parsing features for the student.
+    for (size_t i = featuresStartIndex; i < headersCount; ++i) {
+        std::getline(lineStream, element, ',');
+        if (element.empty()) {
+            student.features.push_back(std::numeric_limits<double>::quiet_NaN());
+        }
+        else if (Utils::isNumber(element)) {
+            student.features.push_back(std::stod(element));
+        }
+        else {
+            throw std::runtime_error("Error: Wrong feature in file : " + element + " at index " + std::to_string(student.index));
+        }
+    }
+
+    return student;
+}
+
+// Function to map every column of a file to its position in the projected labels or features, or -1 to skip it.
+std::vector<ptrdiff_t> projectionSlots(const ColumnProjection& projection, size_t headersCount, size_t featuresStartIndex) {
+    std::vector<ptrdiff_t> slots(headersCount, -1);
+    for (size_t i = 0; i < projection.labels.size(); ++i) {
+        if (1 + projection.labels[i] >= featuresStartIndex) {
+            throw std::runtime_error("Error: No label column " + std::to_string(projection.labels[i] + 1));
+        }
+        slots[1 + projection.labels[i]] = static_cast<ptrdiff_t>(i);
+    }
+    for (size_t i = 0; i < projection.features.size(); ++i) {
+        if (featuresStartIndex + projection.features[i] >= headersCount) {
+            throw std::runtime_error("Error: No feature column " + std::to_string(projection.features[i] + 1));
         }
+        slots[featuresStartIndex + projection.features[i]] = static_cast<ptrdiff_t>(i);
+    }
+    return slots;
+}
 
-        // Parsing features for the student.
-        for (size_t i = featuresStartIndex; i < headersCount; ++i) {
-            std::getline(lineStream, element, ',');
-            if (element.empty()) {
-                student.features.push_back(std::numeric_limits<double>::quiet_NaN());
+// Function to parse the projected columns of a data line. The other columns are only scanned for their delimiter.
+StudentInfo parseProjectedLine(const std::string& line, const std::vector<ptrdiff_t>& slots, size_t featuresStartIndex,
+    const ColumnProjection& projection) {
+    StudentInfo student;
+    student.labels.resize(projection.labels.size());
+    student.features.assign(projection.features.size(), std::numeric_limits<double>::quiet_NaN());
+
+    size_t start = 0;
+    for (size_t column = 0; column < slots.size() && start <= line.size(); ++column) {
+        const size_t end = std::min(line.find(',', start), line.size());
+        const std::string_view element(line.data() + start, end - start);
+        start = end + 1;
+
+        if (column == 0) {
+            long long index = 0;
+            if (!Utils::isNumber(element) || std::from_chars(element.data(), element.data() + element.size(), index).ec != std::errc()) {
+                throw std::runtime_error("Error: Wrong index in file : " + std::string(element) + " at index " + std::to_string(student.index));
             }
-            else if (Utils::isNumber(element)) {
-                student.features.push_back(std::stod(element));
+            student.index = static_cast<size_t>(index);
+        }
+        else if (slots[column] < 0) {
+            continue;
+        }
+        else if (column < featuresStartIndex) {
+            if (!element.empty() && Utils::isNumber(element)) {
+                throw std::runtime_error("Error: Wrong label in file : " + std::string(element) + " at index " + std::to_string(student.index));
             }
-            else {
-                throw std::runtime_error("Error: Wrong feature in file : " + element + " at index " + std::to_string(student.index));
+            student.labels[static_cast<size_t>(slots[column])] = element;
+        }
+        else if (!element.empty()) {
+            double& value = student.features[static_cast<size_t>(slots[column])];
+            if (!Utils::isNumber(element) || std::from_chars(element.data(), element.data() + element.size(), value).ec != std::errc()) {
+                throw std::runtime_error("Error: Wrong feature in file : " + std::string(element) + " at index " + std::to_string(student.index));
             }
         }
+    }
+
+    return student;
+}
+
+// Function to keep only the projected columns of a fully parsed student.
+void projectStudent(StudentInfo& student, const ColumnProjection& projection) {
+    std::vector<std::string> labels;
+    for (size_t label : projection.labels) {
+        labels.push_back(std::move(student.labels.at(label)));
+    }
+    std::vector<double> features;
+    for (size_t feature : projection.features) {
+        features.push_back(student.features.at(feature));
+    }
+    student.labels = std::move(labels);
+    student.features = std::move(features);
+}
+
+// Students parsed from a file, handed to `consume` by chunks of `chunkRows` rows when it is set.
+struct StudentsSink {
+    std::vector<StudentInfo>& students;
+    const std::function<void(std::vector<StudentInfo>&)>* consume = nullptr;
+    size_t chunkRows = 0;
+    size_t rows = 0;
+
+    void push(StudentInfo&& student) {
+        students.push_back(std::move(student));
+        rows++;
+        if (consume && students.size() >= chunkRows) {
+            flush();
+        }
+    }
+
+    void flush() {
+        if (consume && !students.empty()) {
+            (*consume)(students);
+            students.clear();
+        }
+    }
+};
+
+// Function to load data lines from the file and construct StudentInfo objects.
+void loadDataLines(std::ifstream& file, StudentsSink& sink, size_t headersCount, size_t featuresStartIndex,
+    const ColumnProjection* projection) {
+    std::string line;
+    std::getline(file, line);
+
+    if (projection) {
+        const std::vector<ptrdiff_t> slots = projectionSlots(*projection, headersCount, featuresStartIndex);
+        while (std::getline(file, line)) {
+            sink.push(parseProjectedLine(line, slots, featuresStartIndex, *projection));
+        }
+        return;
+    }
+
+    // Iterating through lines to parse and validate index, labels, and features.
+    while (std::getline(file, line)) {
+        sink.push(parseDataLine(line, headersCount, featuresStartIndex));
+    }
+}
+
+// Function to read a raw value from a binary cache.
+template <typename T>
+T readBinaryValue(std::ifstream& file) {
+    T value;
+    if (!file.read(reinterpret_cast<char*>(&value), sizeof(T))) {
+        throw std::runtime_error("Error: Truncated binary cache.");
+    }
+    return value;
+}
+
+// Function to read a length-prefixed string from a binary cache.
+std::string readBinaryString(std::ifstream& file) {
+    std::string value(readBinaryValue<uint32_t>(file), '\0');
+    if (!file.read(value.data(), static_cast<std::streamsize>(value.size()))) {
+        throw std::runtime_error("Error: Truncated binary cache.");
+    }
+    return value;
+}
+
+// Function to check if a file starts with the binary cache magic bytes.
+bool isBinaryCache(const std::string& filename) {
+    const size_t magicSize = std::char_traits<char>::length(Utils::BinaryCacheMagic);
+    std::string magic(magicSize, '\0');
+
+    std::ifstream file(filename, std::ios::binary);
+    return file.read(magic.data(), static_cast<std::streamsize>(magicSize)) && magic == Utils::BinaryCacheMagic;
+}
+
+// Function to load headers and students from a binary cache, keeping only the columns of `projection` when one is
+// given, and returning the features start index.
+size_t loadBinaryCache(const std::string& filename, std::vector<std::string>& headers, StudentsSink& sink,
+    const ColumnProjection* projection) {
+    std::ifstream file(filename, std::ios::binary);
+    file.ignore(static_cast<std::streamsize>(std::char_traits<char>::length(Utils::BinaryCacheMagic)));
+
+    const uint64_t rowsCount = readBinaryValue<uint64_t>(file);
+    const uint32_t headersCount = readBinaryValue<uint32_t>(file);
+    const uint32_t featuresStartIndex = readBinaryValue<uint32_t>(file);
+    if (featuresStartIndex == 0 || featuresStartIndex > headersCount) {
+        throw std::runtime_error("Error: Wrong header in binary cache.");
+    }
 
-        students.push_back(student);
+    for (uint32_t i = 0; i < headersCount; ++i) {
+        headers.push_back(readBinaryString(file));
+    }
+
+    sink.students.reserve(sink.students.size() + static_cast<size_t>(sink.consume ? std::min<uint64_t>(rowsCount, sink.chunkRows) : rowsCount));
+    for (uint64_t row = 0; row < rowsCount; ++row) {
+        StudentInfo student;
+        student.index = static_cast<size_t>(readBinaryValue<uint64_t>(file));
+        for (uint32_t i = 1; i < featuresStartIndex; ++i) {
+            student.labels.push_back(readBinaryString(file));
+        }
+        student.features.resize(headersCount - featuresStartIndex);
+        if (!file.read(reinterpret_cast<char*>(student.features.data()), static_cast<std::streamsize>(student.features.size() * sizeof(double)))) {
+            throw std::runtime_error("Error: Truncated binary cache.");
+        }
+        if (projection) {
+            projectStudent(student, *projection);
+        }
+        sink.push(std::move(student));
     }
+
+    return featuresStartIndex;
 }
 
 // Function to load data from a file, including headers, features start index, and student information.
-std::pair<std::vector<std::string>, size_t> Utils::LoadDataFile(const std::string& filename, std::vector<StudentInfo>& students)
+std::pair<std::vector<std::string>, size_t> loadDataFile(const std::string& filename, StudentsSink& sink,
+    const ColumnProjection* projection)
 {
+    Profiler::Phase phase("load");
     std::vector<std::string> headers;
     size_t featuresStartIndex;
 
@@ -146,46 +438,287 @@ std::pair<std::vector<std::string>, size_t> Utils::LoadDataFile(const std::strin
         throw std::runtime_error("Error: Opening file.");
     }
 
+    if (Profiler::Enabled()) {
+        Profiler::AddCounter("bytes_read", static_cast<double>(std::filesystem::file_size(filename)));
+    }
+
+    // Binary caches store the parsed students directly.
+    if (isBinaryCache(filename)) {
+        Profiler::Phase parsePhase("load.parse");
+        featuresStartIndex = loadBinaryCache(filename, headers, sink, projection);
+        sink.flush();
+        parsePhase.SetRows(sink.rows);
+        Profiler::AddCounter("rows_parsed", static_cast<double>(sink.rows));
+        return { headers, featuresStartIndex };
+    }
+
     // Loading headers from the file.
     loadHeader(file, headers);
 
     // Determining the starting index of features in each data line.
-    determineFeaturesStartIndex(file, headers.size(), featuresStartIndex);
+    {
+        Profiler::Phase scanPhase("load.scan");
+        determineFeaturesStartIndex(file, headers.size(), featuresStartIndex);
+    }
 
     // Resetting the file position to the beginning.
     file.clear();
     file.seekg(0);
 
     // Loading data lines and constructing StudentInfo objects.
-    loadDataLines(file, students, headers.size(), featuresStartIndex);
+    {
+        Profiler::Phase parsePhase("load.parse");
+        loadDataLines(file, sink, headers.size(), featuresStartIndex, projection);
+        sink.flush();
+        parsePhase.SetRows(sink.rows);
+    }
+    Profiler::AddCounter("rows_parsed", static_cast<double>(sink.rows));
 
     file.close();
 
     return { headers, featuresStartIndex };
 }
 
+std::pair<std::vector<std::string>, size_t> Utils::LoadDataFile(const std::string& filename, std::vector<StudentInfo>& students,
+    const ColumnProjection* projection)
+{
+    StudentsSink sink{ students };
+    return loadDataFile(filename, sink, projection);
+}
+
+std::pair<std::vector<std::string>, size_t> Utils::LoadDataFileChunks(const std::string& filename, size_t chunkRows,
+    const std::function<void(std::vector<StudentInfo>&)>& consume, const ColumnProjection* projection)
+{
+    std::vector<StudentInfo> students;
+    StudentsSink sink{ students, &consume, std::max<size_t>(chunkRows, 1) };
+    return loadDataFile(filename, sink, projection);
+}
+
+// Function to return the offset following the last newline of the bytes [begin, end) of a file, or `begin` when
+// they hold none, reading them backwards by chunks.
+size_t lastLineEnd(std::ifstream& file, size_t begin, size_t end) {
+    char chunk[4096];
+    while (end > begin) {
+        const size_t size = std::min(sizeof(chunk), end - begin);
+        file.seekg(static_cast<std::streamoff>(end - size));
+        if (!file.read(chunk, static_cast<std::streamsize>(size))) {
+            throw std::runtime_error("Error: Reading file.");
+        }
+        for (size_t i = size; i > 0; --i) {
+            if (chunk[i - 1] == '\n') {
+                return end - size + i;
+            }
+        }
+        end -= size;
+    }
+    return begin;
+}
+
+// Function to load the complete data lines of a CSV file from a byte offset, returning the offset following them.
+size_t Utils::LoadDataTail(const std::string& filename, size_t offset, std::vector<std::string>& headers, size_t& featuresStartIndex,
+    std::vector<StudentInfo>& students) {
+    Profiler::Phase phase("load");
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("Error: Opening file.");
+    }
+    if (isBinaryCache(filename)) {
+        throw std::runtime_error("Error: Only CSV files can be loaded from an offset : " + filename);
+    }
+
+    // The file may grow while it is read, only the lines complete now are loaded.
+    const size_t size = static_cast<size_t>(std::filesystem::file_size(filename));
+    headers.clear();
+    loadHeader(file, headers);
+    const size_t dataStart = static_cast<size_t>(file.tellg());
+
+    if (featuresStartIndex == 0) {
+        Profiler::Phase scanPhase("load.scan");
+        determineFeaturesStartIndex(file, headers.size(), featuresStartIndex);
+        file.clear();
+    }
+
+    offset = std::max(offset, dataStart);
+    if (offset > size) {
+        throw std::runtime_error("Error: Offset past the end of the file " + filename);
+    }
+
+    // A last line without its newline may still be written, it is left to the next call.
+    const size_t end = lastLineEnd(file, offset, size);
+    Profiler::AddCounter("bytes_read", static_cast<double>(end - offset));
+    file.seekg(static_cast<std::streamoff>(offset));
+
+    const size_t studentsCount = students.size();
+    Profiler::Phase parsePhase("load.parse");
+    std::string line;
+    for (size_t position = offset; position < end && std::getline(file, line); position += line.size() + 1) {
+        if (!line.empty()) {
+            students.push_back(parseDataLine(line, headers.size(), featuresStartIndex));
+        }
+    }
+    parsePhase.SetRows(students.size() - studentsCount);
+    Profiler::AddCounter("rows_parsed", static_cast<double>(students.size() - studentsCount));
+
+    return end;
+}
+
+// Function to expand a comma-separated list of data files and glob patterns.
+std::vector<std::string> Utils::ExpandDataFiles(const std::string& filenames) {
+    std::vector<std::string> files;
+    std::istringstream filenamesStream(filenames);
+
+    for (std::string pattern; std::getline(filenamesStream, pattern, ',');) {
+        if (pattern.empty()) {
+            continue;
+        }
+#ifndef _MSC_VER
+        glob_t matches;
+        if (glob(pattern.c_str(), 0, nullptr, &matches) == 0) {
+            files.insert(files.end(), matches.gl_pathv, matches.gl_pathv + matches.gl_pathc);
+            globfree(&matches);
+            continue;
+        }
+        globfree(&matches);
+#endif // MVS
+        // Patterns matching nothing are kept, so that opening them reports the missing file.
+        files.push_back(pattern);
+    }
+
+    if (files.empty()) {
+        throw std::runtime_error("Error: No data file given.");
+    }
+    return files;
+}
+
+// Function to load data files into a dataset, parsing the shards concurrently.
+Dataset Utils::LoadDataset(const std::string& filenames, const ColumnProjection* projection) {
+    const std::vector<std::string> files = ExpandDataFiles(filenames);
+    std::vector<Dataset> shards(files.size());
+    ParallelFor(files.size(), [&](size_t i) {
+        std::tie(shards[i].headers, shards[i].featuresStartIndex) = LoadDataFile(files[i], shards[i].students, projection);
+    });
+
+    // The shards are appended in order, they must share the header of the first one.
+    Dataset dataset;
+    dataset.headers = shards[0].headers;
+    for (size_t i = 0; i < shards.size(); ++i) {
+        if (shards[i].headers != dataset.headers) {
+            throw std::runtime_error("Error: The header of " + files[i] + " differs from the one of " + files[0]);
+        }
+        if (shards[i].students.empty()) {
+            continue;
+        }
+        if (dataset.students.empty()) {
+            dataset.featuresStartIndex = shards[i].featuresStartIndex;
+        }
+        else if (shards[i].featuresStartIndex != dataset.featuresStartIndex) {
+            throw std::runtime_error("Error: The label columns of " + files[i] + " differ from the ones of the previous shards.");
+        }
+        dataset.students.insert(dataset.students.end(), std::make_move_iterator(shards[i].students.begin()),
+            std::make_move_iterator(shards[i].students.end()));
+    }
+
+    if (dataset.students.empty()) {
+        throw std::runtime_error("Error: No student in the file " + filenames);
+    }
+
+    if (projection) {
+        dataset.featureColumns = projection->features;
+    }
+    else {
+        dataset.featureColumns.resize(dataset.headers.size() - dataset.featuresStartIndex);
+        std::iota(dataset.featureColumns.begin(), dataset.featureColumns.end(), 0);
+    }
+    return dataset;
+}
+
+// Function to copy the students with only some of their features.
+std::vector<StudentInfo> Utils::SelectFeatures(const Dataset& dataset, const std::vector<size_t>& featureColumns, bool keepLabels) {
+    std::vector<size_t> positions;
+    for (size_t column : featureColumns) {
+        auto it = std::find(dataset.featureColumns.begin(), dataset.featureColumns.end(), column);
+        if (it == dataset.featureColumns.end()) {
+            throw std::runtime_error("Error: Feature " + std::to_string(column + 1) + " was not loaded.");
+        }
+        positions.push_back(static_cast<size_t>(it - dataset.featureColumns.begin()));
+    }
+
+    std::vector<StudentInfo> students(dataset.students.size());
+    for (size_t i = 0; i < students.size(); ++i) {
+        const StudentInfo& student = dataset.students[i];
+        students[i].index = student.index;
+        if (keepLabels) {
+            students[i].labels = student.labels;
+        }
+        students[i].features.reserve(positions.size());
+        for (size_t position : positions) {
+            students[i].features.push_back(student.features[position]);
+        }
+    }
+    return students;
+}
+
+std::vector<std::vector<std::span<const double>>> GroupedColumns::views() const {
+    const size_t featuresCount = rows ? values.size() / rows : 0;
+    std::vector<std::vector<std::span<const double>>> groups(begin.size() - 1, std::vector<std::span<const double>>(featuresCount));
+    for (size_t g = 0; g + 1 < begin.size(); ++g) {
+        for (size_t i = 0; i < featuresCount; ++i) {
+            groups[g][i] = group(i, g);
+        }
+    }
+    return groups;
+}
+
+GroupedColumns Utils::GroupFeatures(const std::vector<StudentInfo>& students, size_t labelIndex, const std::vector<std::string>& groups) {
+    // Students of each group, in order, then their values feature by feature
+    std::vector<size_t> groupedStudents;
+    GroupedColumns columns;
+    for (const auto& group : groups) {
+        columns.begin.push_back(groupedStudents.size());
+        for (size_t k = 0; k < students.size(); ++k) {
+            if (students[k].labels[labelIndex] == group) {
+                groupedStudents.push_back(k);
+            }
+        }
+    }
+    columns.begin.push_back(groupedStudents.size());
+
+    const size_t featuresCount = students.empty() ? 0 : students[0].features.size();
+    columns.rows = groupedStudents.size();
+    columns.values.resize(featuresCount * columns.rows);
+    for (size_t i = 0; i < featuresCount; ++i) {
+        double* column = columns.values.data() + i * columns.rows;
+        for (size_t k = 0; k < columns.rows; ++k) {
+            column[k] = students[groupedStudents[k]].features[i];
+        }
+    }
+    return columns;
+}
+
 // Function to execute a system command and print an error message if the execution fails.
 void Utils::executeCommand(const std::string& command) {
+    Profiler::Phase phase("command");
     if (std::system(command.c_str()) != 0) {
         std::cerr << "Error: Executing command" << std::endl;
     }
 }
 
 // Function to print feature headers with a specified maximum width.
-void Utils::printFeatureHeader(const size_t max) {
+void Utils::printFeatureHeader(const size_t max, std::ostream& out) {
     const int fieldWidth = 14;
 
-    std::cout << std::setw(fieldWidth) << std::left << "";
+    out << std::setw(fieldWidth) << std::left << "";
 
     // Printing feature headers with the specified field width.
     for (size_t i = 1; i <= max; i++) {
-        std::cout << std::setw(fieldWidth) << std::right << "Feature " + std::to_string(i);
+        out << std::setw(fieldWidth) << std::right << "Feature " + std::to_string(i);
     }
 
-    std::cout << std::endl;
+    out << std::endl;
 }
 
 void Utils::NormalizeData(std::vector<StudentInfo>& data, std::vector<double>& featureMeans, std::vector<double>& featureStdDevs) {
+    Profiler::Phase phase("normalize", data.size());
     // Calculer la moyenne et l'cart type des caractristiques des donnes
     size_t numFeatures = data[0].features.size();
 
@@ -223,12 +756,15 @@ void Utils::NormalizeData(std::vector<StudentInfo>& data, std::vector<double>& f
 void Utils::SaveWeightsAndNormalizationParameters(const std::vector<std::vector<double>>& weights,
     const std::vector<double>& featureMeans,
     const std::vector<double>& featureStdDevs,
-    const std::string& filename) {
-    // Ouvrir le fichier en mode criture
-    std::ofstream outFile(filename);
+    const std::vector<size_t>& selectedFeatures,
+    const std::string& filename,
+    size_t normalizationRows) {
+    // crire dans un fichier temporaire renomm ensuite, pour qu'une interruption laisse le modle prcdent intact
+    const std::string temporaryFilename = filename + ".tmp";
+    std::ofstream outFile(temporaryFilename);
 
     if (!outFile.is_open()) {
-        std::cerr << "Error: Unable to open the file " << filename << " for writing." << std::endl;
+        std::cerr << "Error: Unable to open the file " << temporaryFilename << " for writing." << std::endl;
         return;
     }
 
@@ -243,7 +779,21 @@ void Utils::SaveWeightsAndNormalizationParameters(const std::vector<std::vector<
     for (double stdDev : featureStdDevs) {
         outFile << " " << stdDev;
     }
-    outFile << "\n\n";
+    outFile << "\n";
+
+    outFile << "SelectedFeatures:";
+    for (size_t feature : selectedFeatures) {
+        outFile << " " << feature;
+    }
+    outFile << "\n";
+
+    // Cette ligne prend la place de la ligne vide, que les anciennes versions ignorent
+    if (normalizationRows > 0) {
+        outFile << "NormalizationRows: " << normalizationRows << "\n";
+    }
+    else {
+        outFile << "\n";
+    }
 
     // Enregistrer les poids
     for (const auto& houseWeights : weights) {
@@ -253,14 +803,19 @@ void Utils::SaveWeightsAndNormalizationParameters(const std::vector<std::vector<
         outFile << "\n";
     }
 
-    // Fermer le fichier
+    // Fermer le fichier puis remplacer l'ancien
     outFile.close();
+    if (!outFile || std::rename(temporaryFilename.c_str(), filename.c_str()) != 0) {
+        std::cerr << "Error: Unable to write the file " << filename << std::endl;
+    }
 }
 
 void Utils::LoadWeightsAndNormalizationParameters(std::vector<std::vector<double>>& weights,
     std::vector<double>& featureMeans,
     std::vector<double>& featureStdDevs,
-    const std::string& filename) {
+    std::vector<size_t>& selectedFeatures,
+    const std::string& filename,
+    size_t* normalizationRows) {
     // Ouvrir le fichier en mode lecture
     std::ifstream inFile(filename);
 
@@ -290,9 +845,25 @@ void Utils::LoadWeightsAndNormalizationParameters(std::vector<std::vector<double
         featureStdDevs.push_back(stdDevValue);
     }
 
+    // Lire les indices des caractristiques, absents des anciens fichiers
+    selectedFeatures.clear();
+    std::getline(inFile, line);
+    if (line.rfind("SelectedFeatures:", 0) == 0) {
+        std::istringstream featuresStream(line.substr(line.find(':') + 1));
+        size_t feature;
+        while (featuresStream >> feature) {
+            selectedFeatures.push_back(feature);
+        }
+        std::getline(inFile, line);
+    }
+
+    // Lire le nombre de lignes de la normalisation,  la place de la ligne vide
+    if (normalizationRows) {
+        *normalizationRows = line.rfind("NormalizationRows:", 0) == 0 ? std::stoull(line.substr(line.find(':') + 1)) : 0;
+    }
+
     // Lire les poids
     weights.clear(); // Assurez-vous de vider le vecteur avant de le remplir
-    std::getline(inFile, line);
     while (std::getline(inFile, line)) {
         std::istringstream weightStream(line);
         double weight;
@@ -303,6 +874,28 @@ void Utils::LoadWeightsAndNormalizationParameters(std::vector<std::vector<double
         weights.push_back(houseWeights);
     }
 
+    // Les anciens fichiers gardent les paramtres de toutes les caractristiques, entranes sur 3, 4 et 7
+    if (selectedFeatures.empty()) {
+        selectedFeatures = { 3, 4, 7 };
+        if (featureMeans.size() > selectedFeatures.size()) {
+            std::vector<double> means, stdDevs;
+            for (size_t feature : selectedFeatures) {
+                means.push_back(featureMeans.at(feature - 1));
+                stdDevs.push_back(featureStdDevs.at(feature - 1));
+            }
+            featureMeans = means;
+            featureStdDevs = stdDevs;
+        }
+    }
+
     // Fermer le fichier
     inFile.close();
-}
\ No newline at end of file
+}
+// Function to read the features used by a model file.
+std::vector<size_t> Utils::LoadSelectedFeatures(const std::string& filename) {
+    std::vector<std::vector<double>> weights;
+    std::vector<double> featureMeans, featureStdDevs;
+    std::vector<size_t> selectedFeatures;
+    LoadWeightsAndNormalizationParameters(weights, featureMeans, featureStdDevs, selectedFeatures, filename);
+    return selectedFeatures;
+}
@@ -0,0 +1,120 @@
+// Compare the describe output over columns stored as floats with the one over doubles.
+// Count must match exactly, and Mean and Std up to the last printed decimal: they are summed in doubles with
+// compensation, only the rounding of the values to floats remains, averaged over the rows. Min, Max and the quartiles
+// are values of the columns (or interpolations between two of them), so they differ by the rounding of a single value
+// to a float, up to 2^-24 of the largest magnitude of the column.
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "commands.h"
+#include "feature_column.h"
+
+namespace {
+
+// Rows of a describe output, by statistic name.
+struct DescribeRow {
+    std::string name;
+    std::vector<double> values;
+};
+
+// Function to parse the rows of a describe output, after its header line
+std::vector<DescribeRow> parseDescribe(const std::string& text) {
+    std::istringstream lines(text);
+    std::string line;
+    std::getline(lines, line);
+    std::vector<DescribeRow> rows;
+    while (std::getline(lines, line)) {
+        std::istringstream fields(line);
+        DescribeRow row;
+        fields >> row.name;
+        for (double value; fields >> value;) {
+            row.values.push_back(value);
+        }
+        rows.push_back(row);
+    }
+    return rows;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    try {
+        if (argc != 2)
+        {
+            std::cerr << "Usage: " << argv[0] << " <dataset>.csv" << std::endl;
+            return 1;
+        }
+
+        std::ostringstream doubles, floats;
+        Commands::Describe(Utils::LoadDataset(argv[1]), doubles);
+        CompactDataset compact = CompactDataset::Load(argv[1], 0.0);
+        compact.ToFloat32();
+        for (const auto& column : compact.features)
+        {
+            if (column.encoding != FeatureColumn::Encoding::Float32)
+            {
+                throw std::runtime_error("Error: A feature column is not stored as floats.");
+            }
+        }
+        Commands::Describe(compact, floats);
+
+        const std::vector<DescribeRow> expected = parseDescribe(doubles.str());
+        const std::vector<DescribeRow> actual = parseDescribe(floats.str());
+        if (expected.size() != actual.size() || expected.empty())
+        {
+            throw std::runtime_error("Error: The describe outputs have different rows.");
+        }
+
+        // Largest magnitude of each column, from its Min and Max rows
+        std::vector<double> magnitudes(expected[0].values.size(), 0.0);
+        for (const auto& row : expected)
+        {
+            for (size_t j = 0; j < row.values.size() && (row.name == "Min" || row.name == "Max"); ++j)
+            {
+                magnitudes[j] = std::max(magnitudes[j], std::abs(row.values[j]));
+            }
+        }
+
+        const double printedDecimal = 1e-6;
+        size_t failures = 0;
+        for (size_t i = 0; i < expected.size(); ++i)
+        {
+            const DescribeRow& row = expected[i];
+            for (size_t j = 0; j < row.values.size(); ++j)
+            {
+                double tolerance = 0.0;
+                if (row.name == "Mean" || row.name == "Std")
+                {
+                    tolerance = printedDecimal;
+                }
+                else if (row.name != "Count")
+                {
+                    tolerance = magnitudes[j] * std::ldexp(1.0, -24) + printedDecimal;
+                }
+                const double difference = std::abs(actual[i].values[j] - row.values[j]);
+                // The comparison keeps a margin for the decimal parsing of the printed values
+                if (actual[i].name != row.name || difference > tolerance * (1.0 + 1e-9) + 1e-12)
+                {
+                    std::cerr << std::fixed << std::setprecision(6) << row.name << " of feature " << j + 1 << ": " << actual[i].values[j]
+                        << " over floats, " << row.values[j] << " over doubles" << std::endl;
+                    failures++;
+                }
+            }
+        }
+        if (failures != 0)
+        {
+            return EXIT_FAILURE;
+        }
+        std::cout << "describe_float32_test: OK (" << expected.size() << " statistics of " << magnitudes.size()
+            << " features)" << std::endl;
+    }
+    catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    return 0;
+}
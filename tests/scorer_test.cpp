@@ -0,0 +1,29 @@
+// Score a data file with the header written by logreg_compile and print the houses in the format of logreg_predict,
+// so that both outputs can be compared with diff.
+#include <iostream>
+#include "utils.h"
+#include "scorer.h"
+
+int main(int argc, char* argv[])
+{
+    try {
+        if (argc != 2)
+        {
+            std::cerr << "Usage: " << argv[0] << " <dataset>.csv" << std::endl;
+            return 1;
+        }
+
+        // Every feature column of the file, in order, as the generated scorer indexes them
+        const Dataset dataset = Utils::LoadDataset(argv[1]);
+        std::cout << dataset.headers[0] << "," << dataset.headers[1] << "\n";
+        for (const auto& student : dataset.students)
+        {
+            std::cout << student.index << "," << dslr_model::Houses[dslr_model::score(student.features.data())] << "\n";
+        }
+    }
+    catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    return 0;
+}